@@ -1,20 +1,256 @@
 import sys
+import argparse
 import serial
+import math
 import threading
+import time
 from PyQt6.QtWidgets import (
     QApplication, QWidget, QVBoxLayout, QLabel, QSlider, QPushButton,
-    QHBoxLayout, QMessageBox, QTabWidget, QGridLayout, QDoubleSpinBox
+    QHBoxLayout, QMessageBox, QTabWidget, QGridLayout, QDoubleSpinBox, QCheckBox,
+    QComboBox
 )
 from PyQt6.QtCore import Qt, QTimer, pyqtSignal
-import pyqtgraph as pg
+
+import adpcm
+from spectrum_view import SpectrumView
+
+try:
+    from PyQt6.QtMultimedia import QAudioFormat, QAudioSink, QMediaDevices
+except ImportError:  # monitor playback is optional
+    QAudioSink = None
+
+
+class MonitorPlayer:
+    """Jitter buffer in front of a QAudioSink for the MON: stream.
+
+    push() is called from the serial thread, pump() runs on a GUI timer.
+    Playback starts once target_ms is buffered, restarts priming after an
+    underrun, and drops the oldest audio when latency grows past max_ms.
+    """
+
+    def __init__(self, target_ms=150, max_ms=600):
+        self.target_ms = target_ms
+        self.max_ms = max_ms
+        self.lock = threading.Lock()
+        self.buf = bytearray()
+        self.rate = 0
+        self.sink_rate = 0
+        self.sink = None
+        self.dev = None
+        self.priming = True
+        self.last_seq = None
+        self.lost = 0
+        self.underruns = 0
+        self.timer = QTimer()
+        self.timer.timeout.connect(self.pump)
+
+    def start(self):
+        self.timer.start(20)
+
+    def stop(self):
+        self.timer.stop()
+        if self.sink:
+            self.sink.stop()
+        self.sink = self.dev = None
+        self.sink_rate = 0
+        with self.lock:
+            self.buf.clear()
+            self.last_seq = None
+            self.priming = True
+
+    def push(self, seq, rate, samples):
+        with self.lock:
+            if self.last_seq is not None and seq > self.last_seq + 1:
+                self.lost += seq - self.last_seq - 1
+            self.last_seq = seq
+            if rate != self.rate:
+                self.rate = rate
+                self.buf.clear()
+                self.priming = True
+            self.buf += samples.tobytes()
+            max_bytes = 2 * rate * self.max_ms // 1000
+            if len(self.buf) > max_bytes:
+                del self.buf[:len(self.buf) - max_bytes]
+
+    def _open_sink(self, rate):
+        fmt = QAudioFormat()
+        fmt.setSampleRate(rate)
+        fmt.setChannelCount(1)
+        fmt.setSampleFormat(QAudioFormat.SampleFormat.Int16)
+        if self.sink:
+            self.sink.stop()
+        self.sink = QAudioSink(QMediaDevices.defaultAudioOutput(), fmt)
+        self.sink.setBufferSize(2 * rate * self.target_ms // 1000)
+        self.dev = self.sink.start()
+        self.sink_rate = rate
+
+    def pump(self):
+        with self.lock:
+            rate = self.rate
+            if not rate:
+                return
+            if self.priming:
+                if len(self.buf) < 2 * rate * self.target_ms // 1000:
+                    return
+                self.priming = False
+            if rate != self.sink_rate:
+                self._open_sink(rate)
+
+            free = self.sink.bytesFree() & ~1
+            if not self.buf:
+                if free >= self.sink.bufferSize():      # sink ran dry
+                    self.underruns += 1
+                    self.priming = True
+                return
+            chunk = bytes(self.buf[:free])
+            del self.buf[:len(chunk)]
+        self.dev.write(chunk)
+
+    def latency_ms(self):
+        with self.lock:
+            return 1000 * len(self.buf) // (2 * self.rate) if self.rate else 0
+
+
+class ParamBatcher:
+    """Coalesces parameter changes into rate-capped SET batches.
+
+    set() only records the latest value per key; every `interval_ms` the
+    pending keys go out as one `SET <seq> K=V,...` line. A new batch waits
+    for the previous ACK (or a timeout) so slider drags never queue up.
+    """
+
+    def __init__(self, send, interval_ms=50, ack_timeout_ms=500):
+        self.send = send
+        self.ack_timeout = ack_timeout_ms / 1000.0
+        self.lock = threading.Lock()
+        self.pending = {}
+        self.seq = 0
+        self.in_flight = None       # (seq, sent_at)
+        self.timer = QTimer()
+        self.timer.timeout.connect(self.flush)
+        self.timer.start(interval_ms)
+
+    def set(self, key, value):
+        with self.lock:
+            self.pending[key] = value
+
+    def flush(self):
+        with self.lock:
+            if not self.pending:
+                return
+            if self.in_flight and time.monotonic() - self.in_flight[1] < self.ack_timeout:
+                return
+            self.seq += 1
+            items = ",".join(f"{k}={v:.3f}" for k, v in self.pending.items())
+            self.pending.clear()
+            self.in_flight = (self.seq, time.monotonic())
+            line = f"SET {self.seq} {items}\n"
+        self.send(line)
+
+    def on_reply(self, line):
+        """ACK <seq> <n> / NAK <seq> <reason> from the serial thread."""
+        parts = line.split()
+        with self.lock:
+            if self.in_flight and len(parts) >= 2 and parts[1] == str(self.in_flight[0]):
+                self.in_flight = None
+        return parts[0] == "ACK"
+
+
+def parse_param_line(line):
+    """PARAM:<id>,<name>,<group>,<unit>,<type>,<min>,<max>,<default>,<value>"""
+    f = line[len("PARAM:"):].split(",")
+    if len(f) != 9:
+        return None
+    try:
+        return {"id": int(f[0]), "name": f[1], "group": f[2], "unit": f[3], "type": f[4],
+                "min": float(f[5]), "max": float(f[6]), "default": float(f[7]), "value": float(f[8])}
+    except ValueError:
+        return None
+
+
+class ParamRow:
+    """Label + slider + spin box (or check box) bound to one registry entry.
+
+    Sliders have 1000 steps; Hz and ms ranges are mapped logarithmically.
+    """
+    STEPS = 1000
+
+    def __init__(self, p, on_change):
+        self.p = p
+        self.on_change = on_change
+        self.log = p["unit"] in ("Hz", "ms") and p["min"] > 0
+        self.label = QLabel(p["name"].split("_", 1)[-1].replace("_", " ").title()
+                            + (f" ({p['unit']})" if p["unit"] else ""))
+        self.slider = self.spin = self.check = None
+
+        if p["type"] == "b":
+            self.check = QCheckBox()
+            self.check.setChecked(p["value"] != 0)
+            self.check.toggled.connect(lambda on: self.on_change(self.p["name"], 1.0 if on else 0.0))
+            return
+
+        self.slider = QSlider(Qt.Orientation.Horizontal)
+        self.slider.setRange(0, self.STEPS)
+        self.spin = QDoubleSpinBox()
+        self.spin.setRange(p["min"], p["max"])
+        self.spin.setDecimals(0 if p["type"] == "i" else 3)
+        self.spin.setSingleStep((p["max"] - p["min"]) / 100)
+        self.spin.setKeyboardTracking(False)
+        self.set_value(p["value"])
+        self.slider.valueChanged.connect(self._slider_moved)
+        self.spin.valueChanged.connect(self._spin_changed)
+
+    def to_pos(self, v):
+        lo, hi = self.p["min"], self.p["max"]
+        t = math.log(v / lo) / math.log(hi / lo) if self.log else (v - lo) / (hi - lo)
+        return int(round(min(max(t, 0.0), 1.0) * self.STEPS))
+
+    def to_value(self, pos):
+        lo, hi, t = self.p["min"], self.p["max"], pos / self.STEPS
+        return lo * (hi / lo) ** t if self.log else lo + (hi - lo) * t
+
+    def set_value(self, v):
+        """Reflect a value without sending it back."""
+        if self.check:
+            self.check.blockSignals(True)
+            self.check.setChecked(v != 0)
+            self.check.blockSignals(False)
+            return
+        for w, val in ((self.slider, self.to_pos(v)), (self.spin, v)):
+            w.blockSignals(True)
+            w.setValue(val)
+            w.blockSignals(False)
+
+    def _slider_moved(self, pos):
+        v = self.to_value(pos)
+        self.spin.blockSignals(True)
+        self.spin.setValue(v)
+        self.spin.blockSignals(False)
+        self.on_change(self.p["name"], v)
+
+    def _spin_changed(self, v):
+        self.slider.blockSignals(True)
+        self.slider.setValue(self.to_pos(v))
+        self.slider.blockSignals(False)
+        self.on_change(self.p["name"], v)
 
 
 class DSPGUI(QWidget):
     rms_updated = pyqtSignal(float)
-    fft_updated = pyqtSignal(list)
-
-    def __init__(self, port="/dev/ttyUSB0", baudrate=115200):
+    vad_updated = pyqtSignal(float)
+    meters_updated = pyqtSignal(dict)
+    pitch_updated = pyqtSignal(dict)
+    registry_received = pyqtSignal(list)
+    param_updated = pyqtSignal(dict)
+    rate_changed = pyqtSignal(int)
+
+    TAB_TITLES = {"EQ": "EQ 3 Bandes", "EXPANDER": "Expander", "COMP": "Compressor", "LIMIT": "Limiter",
+                  "DYNEQ": "Dynamic EQ"}
+    SUBSCRIPTIONS = "METERS=10,SPECTRUM=10,PITCH=10"     # streams this window displays, in Hz
+
+    def __init__(self, port="/dev/ttyUSB0", baudrate=115200, verbose=False):
         super().__init__()
+        self.verbose = verbose      # echo serial traffic to stdout (slow at high data rates)
         self.setWindowTitle("ESP32 DSP Controller")
         self.resize(800, 600)
 
@@ -25,6 +261,8 @@ class DSPGUI(QWidget):
             QMessageBox.critical(self, "Erreur", f"Impossible d’ouvrir le port série {port}")
             sys.exit(1)
 
+        self.params = ParamBatcher(self.send_cmd)
+
         # === Main layout ===
         layout = QVBoxLayout()
         self.tabs = QTabWidget()
@@ -32,159 +270,72 @@ class DSPGUI(QWidget):
         self.setLayout(layout)
 
         # === Tabs ===
-        self.tabs.addTab(self.make_eq_tab(), "EQ 3 Bandes")
-        self.tabs.addTab(self.make_expander_tab(), "Expander")
-        self.tabs.addTab(self.make_compressor_tab(), "Compressor")
-        self.tabs.addTab(self.make_limiter_tab(), "Limiter")
+        # parameter tabs are built from the firmware registry (DUMP)
+        self.param_rows = {}
+        self.param_tabs = []
+        self.dump_lines = {}
         self.tabs.addTab(self.make_monitor_tab(), "Monitoring")
 
         # === Connect signals ===
+        self.registry_received.connect(self.build_param_tabs)
+        self.param_updated.connect(self.update_param_row)
         self.rms_updated.connect(self.update_rms_label)
-        self.fft_updated.connect(self.update_fft_plot)
+        self.vad_updated.connect(self.update_vad_label)
+        self.meters_updated.connect(self.update_meters_label)
+        self.pitch_updated.connect(self.update_pitch_label)
 
         # === Serial listening thread ===
         self.listen_thread = threading.Thread(target=self.listen_serial, daemon=True)
         self.listen_thread.start()
 
-    # ============================================================
-    # -------------------- EQ TAB -------------------------------
-    # ============================================================
-    def _sync_set_spin(self, spin, value: float):
-        spin.blockSignals(True)
-        try:
-            spin.setValue(value)
-        finally:
-            spin.blockSignals(False)
-
-    def _sync_set_slider_raw(self, slider, raw: int):
-        slider.blockSignals(True)
-        try:
-            slider.setValue(raw)
-        finally:
-            slider.blockSignals(False)
-
-    def send_eq_q(self, band, value, label, unit, slider=None, spin=None):
-        value = max(0.1, min(10.0, float(value)))
-        if slider is not None:
-            self._sync_set_slider_raw(slider, int(round(value * 1000)))
-        if spin is not None:
-            self._sync_set_spin(spin, value)
-        label.setText(f"Q = {value:.3f} {unit}")
-        self.send_cmd(f"EQ_{band}_Q={value:.3f}\n")
-    
-    
-    def make_eq_tab(self):
-        tab = QWidget()
-        grid = QGridLayout()
-
-        bands = ["LOW", "MID", "HIGH"]
-        params = [
-            ("fc", 20, 20000, 1000, "Hz"),
-            ("Q", 0.1, 10.0, 1.0, ""),
-            ("gain", -12, 12, 0, "dB"),
-        ]
-
-        row = 0
-        for b in bands:
-            title = QLabel(f"Band: {b}")
-            grid.addWidget(title, row, 0)
-            row += 1
-
-            for (p, vmin, vmax, vinit, unit) in params:
-                label = QLabel(f"{p.upper()} = {vinit} {unit}")
-                if p == "Q":
-                    q_slider = QSlider(Qt.Orientation.Horizontal)
-                    q_slider.setMinimum(int(vmin * 1000))
-                    q_slider.setMaximum(int(vmax * 1000))
-                    q_slider.setValue(int(vinit * 1000))
-                    q_slider.setTracking(False)
-
-                    q_spin = QDoubleSpinBox()
-                    q_spin.setDecimals(3)
-                    q_spin.setRange(vmin, vmax)
-                    q_spin.setSingleStep(0.001)
-                    q_spin.setKeyboardTracking(False)
-                    q_spin.setValue(vinit)
-
-                    q_slider.valueChanged.connect(
-                        lambda raw, band=b, lbl=label, u=unit, sp=q_spin:
-                            self.send_eq_q(band, raw / 1000.0, lbl, u, slider=None, spin=sp)
-                    )
-                    q_spin.valueChanged.connect(
-                        lambda v, band=b, lbl=label, u=unit, sl=q_slider, sp=q_spin:
-                            self.send_eq_q(band, float(v), lbl, u, slider=sl, spin=None)
-                    )
-
-                    grid.addWidget(label, row, 0)
-                    grid.addWidget(q_slider, row, 1, 1, 2)
-                    grid.addWidget(q_spin, row, 3)
-                    row += 1
-                else:
-                    slider = QSlider(Qt.Orientation.Horizontal)
-                    slider.setMinimum(int(vmin * 10))
-                    slider.setMaximum(int(vmax * 10))
-                    slider.setValue(int(vinit * 10))
-                    slider.valueChanged.connect(
-                        lambda val, band=b, param=p, lbl=label, u=unit:
-                            self.send_eq_param(band, param, val / 10.0, lbl, u)
-                    )
-                    grid.addWidget(label, row, 0)
-                    grid.addWidget(slider, row, 1, 1, 3)
-                    row += 1
-
-        tab.setLayout(grid)
-        return tab
+        self.dump_timer = QTimer()
+        self.dump_timer.timeout.connect(lambda: self.send_cmd("DUMP\n"))
+        self.dump_timer.start(2000)
+        self.send_cmd("DUMP\n")
 
-    def send_eq_param(self, band, param, value, label, unit):
-        label.setText(f"{param.upper()} = {value:.2f} {unit}")
-        cmd = f"EQ_{band}_{param.upper()}={value:.2f}\n"
-        self.send_cmd(cmd)
+        # telemetry only flows while subscribed; re-sent well within the
+        # firmware's 5 s lease, so it also acts as the keepalive
+        self.sub_timer = QTimer()
+        self.sub_timer.timeout.connect(self.subscribe)
+        self.sub_timer.start(2000)
+        self.subscribe()
 
     # ============================================================
-    # -------------------- EXPANDER / COMP / LIMITER -------------
+    # -------------------- PARAMETER TABS ------------------------
     # ============================================================
-    def make_expander_tab(self):
-        return self.make_block_tab("EXPANDER", [
-            ("THRESHOLD", 0.0, 1.0, 0.02),
-            ("RATIO", 1.0, 10.0, 2.0),
-            ("ATTACK", 0.0, 0.1, 0.01),
-            ("RELEASE", 0.01, 0.3, 0.1),
-            ("HOLD", 0.0, 1.0, 0.1)
-        ])
-
-    def make_compressor_tab(self):
-        return self.make_block_tab("COMP", [
-            ("THRESHOLD", 0.0, 1.0, 0.3),
-            ("RATIO", 1.0, 10.0, 2.0),
-            ("MAKEUP", 0.0, 2.0, 1.0),
-            ("ATTACK", 0.0, 0.1, 0.01),
-            ("RELEASE", 0.01, 0.3, 0.1),
-            ("KNEE", 0.0, 12.0, 6.0)
-        ])
-
-    def make_limiter_tab(self):
-        return self.make_block_tab("LIMIT", [
-            ("THRESHOLD", 0.0, 1.0, 0.9),
-            ("ATTACK", 0.0, 0.1, 0.01),
-            ("RELEASE", 0.01, 0.3, 0.1)
-        ])
-
-    def make_block_tab(self, name, sliders):
-        tab = QWidget()
-        layout = QVBoxLayout()
-        for param, vmin, vmax, vinit in sliders:
-            label = QLabel(f"{param} = {vinit}")
-            slider = QSlider(Qt.Orientation.Horizontal)
-            slider.setMinimum(int(vmin * 100))
-            slider.setMaximum(int(vmax * 100))
-            slider.setValue(int(vinit * 100))
-            slider.valueChanged.connect(
-                lambda val, n=param, lbl=label, block=name:
-                    self.send_param(block, n, val / 100.0, lbl))
-            layout.addWidget(label)
-            layout.addWidget(slider)
-        tab.setLayout(layout)
-        return tab
+    def build_param_tabs(self, params):
+        self.dump_timer.stop()
+        for tab in self.param_tabs:
+            self.tabs.removeTab(self.tabs.indexOf(tab))
+        self.param_tabs.clear()
+        self.param_rows.clear()
+
+        groups = {}
+        for p in params:
+            groups.setdefault(p["group"], []).append(p)
+
+        for i, (group, plist) in enumerate(groups.items()):
+            tab = QWidget()
+            grid = QGridLayout()
+            for row, p in enumerate(plist):
+                r = ParamRow(p, self.params.set)
+                self.param_rows[p["name"]] = r
+                grid.addWidget(r.label, row, 0)
+                if r.check:
+                    grid.addWidget(r.check, row, 1)
+                else:
+                    grid.addWidget(r.slider, row, 1)
+                    grid.addWidget(r.spin, row, 2)
+            grid.setRowStretch(len(plist), 1)
+            tab.setLayout(grid)
+            self.tabs.insertTab(i, tab, self.TAB_TITLES.get(group, group.title()))
+            self.param_tabs.append(tab)
+        self.tabs.setCurrentIndex(0)
+
+    def update_param_row(self, p):
+        row = self.param_rows.get(p["name"])
+        if row:
+            row.set_value(p["value"])
 
     # ============================================================
     # -------------------- MONITOR TAB ---------------------------
@@ -196,63 +347,155 @@ class DSPGUI(QWidget):
         self.rms_label = QLabel("RMS: 0.0 dBFS")
         layout.addWidget(self.rms_label)
 
-        # FFT graph configuration
-        self.fft_plot = pg.PlotWidget(title="Spectre FFT (8 bandes)")
-        self.fft_plot.setYRange(-80, 0)
-        self.fft_plot.setLabel('left', 'Amplitude (dB)')
-        self.fft_plot.setLabel('bottom', 'Bandes')
-        self.fft_plot.showGrid(x=True, y=True)
-
-        # 8 band create
-        self.fft_x = list(range(8))
-        self.fft_bar = pg.BarGraphItem(x=self.fft_x, height=[-80]*8, width=0.8, brush='cyan')
-        self.fft_plot.addItem(self.fft_bar)
-        layout.addWidget(self.fft_plot)
+        self.vad_label = QLabel("Voice: --")
+        layout.addWidget(self.vad_label)
+
+        self.pitch_label = QLabel("Pitch: --")
+        layout.addWidget(self.pitch_label)
+
+        # I2S sample rate, switched by the firmware between two blocks
+        rate_row = QHBoxLayout()
+        rate_row.addWidget(QLabel("Sample rate"))
+        self.rate_combo = QComboBox()
+        for hz in (48000, 32000, 16000):
+            self.rate_combo.addItem(f"{hz // 1000} kHz", hz)
+        self.rate_combo.currentIndexChanged.connect(
+            lambda i: self.send_cmd(f"RATE {self.rate_combo.itemData(i)}\n"))
+        self.rate_changed.connect(self.update_rate_combo)
+        rate_row.addWidget(self.rate_combo)
+        deess = QPushButton("De-esser preset")
+        deess.clicked.connect(lambda: self.send_cmd("PRESET DEESS\n"))
+        rate_row.addWidget(deess)
+        rate_row.addStretch()
+        layout.addLayout(rate_row)
+
+        # ADPCM monitor stream playback
+        self.monitor = MonitorPlayer() if QAudioSink else None
+        self.monitor_check = QCheckBox("Listen (monitor stream, ADPCM)")
+        self.monitor_check.setEnabled(self.monitor is not None)
+        self.monitor_check.toggled.connect(self.toggle_monitor)
+        self.monitor_label = QLabel("")
+        layout.addWidget(self.monitor_check)
+        layout.addWidget(self.monitor_label)
+        self.monitor_stats_timer = QTimer()
+        self.monitor_stats_timer.timeout.connect(self.update_monitor_label)
+
+        self.meters_label = QLabel("IN: -- dBFS | OUT: -- dBFS | GR: --")
+        layout.addWidget(self.meters_label)
+
+        # FFT bars, peak hold and waterfall, fed straight from the serial thread
+        self.spectrum = SpectrumView(bands=8)
+        layout.addWidget(self.spectrum)
 
         tab.setLayout(layout)
         return tab
 
 
+    def subscribe(self):
+        self.send_cmd(f"SUB {self.SUBSCRIPTIONS}\n")
+
     def update_rms_label(self, val):
         self.rms_label.setText(f"RMS: {val:.1f} dBFS")
 
-    def update_fft_plot(self, bands):
-       
-        if len(bands) != 8:
-            print(" Données FFT inattendues :", bands)
-            return
-
-        # erase old graph and draw new one
-        self.fft_plot.clear()
-        self.fft_bar = pg.BarGraphItem(
-            x=self.fft_x,
-            height=bands,
-            width=0.8,
-            brush='cyan'
-        )
-        self.fft_plot.addItem(self.fft_bar)
-
+    def toggle_monitor(self, on):
+        if on:
+            self.monitor.start()
+            self.monitor_stats_timer.start(500)
+            self.send_cmd("MONITOR ON 8000\n")
+        else:
+            self.send_cmd("MONITOR OFF\n")
+            self.monitor.stop()
+            self.monitor_stats_timer.stop()
+            self.monitor_label.setText("")
+
+    def update_rate_combo(self, hz):
+        i = self.rate_combo.findData(hz)
+        if i >= 0 and i != self.rate_combo.currentIndex():
+            self.rate_combo.blockSignals(True)
+            self.rate_combo.setCurrentIndex(i)
+            self.rate_combo.blockSignals(False)
+
+    def update_monitor_label(self):
+        m = self.monitor
+        self.monitor_label.setText(
+            f"{m.rate or '--'} Hz | buffer {m.latency_ms()} ms | lost frames {m.lost} | underruns {m.underruns}")
+
+    def update_vad_label(self, p):
+        self.vad_label.setText(f"Voice: {'SPEECH' if p >= 0.5 else 'silence'} (p={p:.2f})")
+
+    def update_pitch_label(self, p):
+        if p.get("VOICED"):
+            self.pitch_label.setText(f"Pitch: {p['F0']:.0f} Hz (conf {p['CONF']:.2f})")
+        else:
+            self.pitch_label.setText("Pitch: --")
+
+    def update_meters_label(self, m):
+        self.meters_label.setText(
+            f"IN pk {m['IPK']:.1f} / rms {m['IRMS']:.1f} dBFS | "
+            f"OUT pk {m['OPK']:.1f} / tp {m['OTP']:.1f} / rms {m['ORMS']:.1f} dBFS | "
+            f"GR exp {m['GRE']:.1f} comp {m['GRC']:.1f} lim {m['GRL']:.1f} dB | "
+            f"clips {int(m['CLI'])}/{int(m['CLO'])}")
 
     # ============================================================
     # -------------------- SERIAL COMM ---------------------------
     # ============================================================
-    def send_param(self, block, name, value, label):
-        label.setText(f"{name} = {value:.2f}")
-        cmd = f"{block}_{name}={value:.2f}\n"
-        self.send_cmd(cmd)
-
     def send_cmd(self, cmd):
         self.ser.write(cmd.encode())
-        print("→", cmd.strip())
+        if self.verbose:
+            print("→", cmd.strip())
 
     def listen_serial(self):
         """Listen esp32 msg"""
+        verbose = self.verbose
         while True:
             try:
                 line = self.ser.readline().decode(errors="ignore").strip()
                 if not line:
                     continue
-                print("←", line)
+                if verbose:
+                    print("←", line)
+
+                if line.startswith("PARAM:"):
+                    if line.startswith("PARAM:END"):
+                        self.registry_received.emit(sorted(self.dump_lines.values(), key=lambda p: p["id"]))
+                        self.dump_lines = {}
+                    else:
+                        p = parse_param_line(line)
+                        if p:
+                            self.dump_lines[p["id"]] = p
+                            self.param_updated.emit(p)
+                    continue
+
+                if line.startswith(("ACK ", "NAK ")):
+                    if not self.params.on_reply(line):
+                        print("rejected :", line)
+                    continue
+
+                if line.startswith(("OK RATE=", "RATE=")):
+                    self.rate_changed.emit(int(line.split("=")[1]))
+                    continue
+
+                if line.startswith("MON:"):
+                    frame = adpcm.parse_mon_line(line)
+                    if frame and self.monitor:
+                        self.monitor.push(*frame)
+                    continue
+
+                if line.startswith("METERS:"):
+                    try:
+                        fields = dict(kv.split("=") for kv in line[len("METERS:"):].split(","))
+                        self.meters_updated.emit({k: float(v) for k, v in fields.items()})
+                    except ValueError:
+                        print("wrong meters parsing :", line)
+                    continue
+
+                if line.startswith("PITCH:F0="):
+                    try:
+                        fields = dict(kv.split("=") for kv in line[len("PITCH:"):].split(","))
+                        self.pitch_updated.emit({k: float(v) for k, v in fields.items()})
+                    except ValueError:
+                        print("wrong pitch parsing :", line)
+                    continue
 
                 if line.startswith("STREAM:"):
                     line = line.replace("STREAM:", "")
@@ -266,17 +509,22 @@ class DSPGUI(QWidget):
                         except ValueError:
                             pass
 
-                    # Get FFT
+                    # Get VAD probability
+                    if "VAD=" in line:
+                        try:
+                            self.vad_updated.emit(float(line.split("VAD=")[1].split(",")[0]))
+                        except ValueError:
+                            pass
+
+                    # Get FFT (any band count, the view adapts)
                     if "FFT=" in line:
                         try:
-                            fft_str = line.split("FFT=")[1]
-                            fft_vals = [float(x) for x in fft_str.split(",") if x.strip()]
-                            if len(fft_vals) == 8:
-                                self.fft_updated.emit(fft_vals)
-                            else:
-                                print("wrong fft data :", fft_vals)
+                            fft_vals = [float(x) for x in line.split("FFT=")[1].split(",") if x.strip()]
+                            if fft_vals:
+                                self.spectrum.push(fft_vals)
                         except ValueError:
-                            print("wrong fft parsing :", line)
+                            if verbose:
+                                print("wrong fft parsing :", line)
 
 
             except serial.SerialException:
@@ -284,8 +532,13 @@ class DSPGUI(QWidget):
 
 
 if __name__ == "__main__":
-    port = "/dev/ttyUSB0"  
+    ap = argparse.ArgumentParser(description="ESP32 DSP controller")
+    ap.add_argument("--port", default="/dev/ttyUSB0")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("-v", "--verbose", action="store_true", help="print serial traffic")
+    args = ap.parse_args()
+
     app = QApplication(sys.argv)
-    gui = DSPGUI(port)
+    gui = DSPGUI(args.port, args.baud, args.verbose)
     gui.show()
     sys.exit(app.exec())
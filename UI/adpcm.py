@@ -0,0 +1,47 @@
+"""IMA-ADPCM decoder for the MON: monitor stream (matches main/dsp/adpcm.c)."""
+import array
+import base64
+
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8,
+               -1, -1, -1, -1, 2, 4, 6, 8]
+
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767]
+
+
+def decode(data, predictor, index):
+    """Decode packed nibbles (low first), returns array('h') of samples."""
+    out = array.array("h")
+    for byte in data:
+        for code in (byte & 0x0F, byte >> 4):
+            step = STEP_TABLE[index]
+            vpdiff = step >> 3
+            if code & 4:
+                vpdiff += step
+            if code & 2:
+                vpdiff += step >> 1
+            if code & 1:
+                vpdiff += step >> 2
+            predictor += -vpdiff if code & 8 else vpdiff
+            predictor = max(-32768, min(32767, predictor))
+            index = max(0, min(88, index + INDEX_TABLE[code]))
+            out.append(predictor)
+    return out
+
+
+def parse_mon_line(line):
+    """'MON:seq,rate,pred,index,b64' -> (seq, rate, samples) or None."""
+    try:
+        seq, rate, pred, index, payload = line[len("MON:"):].split(",", 4)
+        samples = decode(base64.b64decode(payload), int(pred), int(index))
+        return int(seq), int(rate), samples
+    except (ValueError, IndexError):
+        return None
@@ -0,0 +1,80 @@
+"""Headless spectrum rendering benchmark.
+
+Feeds synthetic spectra as fast as possible and reports rendered frames per
+second for the legacy path (clear + new BarGraphItem per frame) and for
+SpectrumView (in-place updates + waterfall). Each frame is painted
+synchronously so the numbers include Qt rendering.
+
+    QT_QPA_PLATFORM=offscreen python UI/bench_render.py [--bands 8 256] [--seconds 3]
+"""
+import argparse
+import os
+import sys
+import time
+
+os.environ.setdefault("QT_QPA_PLATFORM", "offscreen")
+
+import numpy as np
+import pyqtgraph as pg
+from PyQt6.QtWidgets import QApplication
+
+from spectrum_view import SpectrumView
+
+
+def synthetic(bands, frames, seed=1):
+    rng = np.random.default_rng(seed)
+    base = np.linspace(-20, -60, bands, dtype=np.float32)
+    return base + rng.normal(0, 6, (frames, bands)).astype(np.float32)
+
+
+def bench_legacy(app, data, seconds):
+    plot = pg.PlotWidget()
+    plot.resize(800, 300)
+    plot.show()
+    x = list(range(data.shape[1]))
+    n = 0
+    t0 = time.perf_counter()
+    while time.perf_counter() - t0 < seconds:
+        plot.clear()
+        plot.addItem(pg.BarGraphItem(x=x, height=list(data[n % len(data)]), width=0.8, brush='cyan'))
+        plot.repaint()
+        app.processEvents()
+        n += 1
+    plot.close()
+    return n / (time.perf_counter() - t0)
+
+
+def bench_view(app, data, seconds):
+    view = SpectrumView(bands=data.shape[1])
+    view.timer.stop()               # drive render() directly
+    view.resize(800, 600)
+    view.show()
+    n = 0
+    t0 = time.perf_counter()
+    while time.perf_counter() - t0 < seconds:
+        view.push(data[n % len(data)])
+        view.render()
+        view.repaint()
+        app.processEvents()
+        n += 1
+    view.close()
+    return n / (time.perf_counter() - t0)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--bands", type=int, nargs="+", default=[8, 64, 256])
+    ap.add_argument("--seconds", type=float, default=3.0)
+    args = ap.parse_args()
+
+    app = QApplication(sys.argv)
+    print(f"{'bands':>6} {'legacy fps':>11} {'view fps':>9}")
+    for bands in args.bands:
+        data = synthetic(bands, 512)
+        legacy = bench_legacy(app, data, args.seconds)
+        view = bench_view(app, data, args.seconds)
+        print(f"{bands:>6} {legacy:>11.1f} {view:>9.1f}")
+
+
+if __name__ == "__main__":
+    main()
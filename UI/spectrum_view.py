@@ -0,0 +1,132 @@
+"""Spectrum bars + peak hold + scrolling waterfall, redrawn on a frame timer.
+
+Frames are written into a preallocated numpy ring from any thread (push());
+a QTimer on the GUI thread redraws at most once per tick and only when new
+data arrived. Peak hold / decay advances on every tick by the real elapsed
+time, so peaks still fall while the stream is paused or the timer lags.
+Plot items are created once and updated in place.
+"""
+import threading
+import time
+
+import numpy as np
+import pyqtgraph as pg
+from PyQt6.QtCore import QTimer
+from PyQt6.QtWidgets import QWidget, QVBoxLayout
+
+
+class SpectrumView(QWidget):
+    def __init__(self, bands=8, history=256, fps=60, floor_db=-80.0,
+                 peak_hold_s=1.0, peak_decay_db_s=20.0, parent=None):
+        super().__init__(parent)
+        self.floor_db = floor_db
+        self.history = history
+        self.fps = fps
+        self.peak_hold_s = peak_hold_s
+        self.peak_decay_db_s = peak_decay_db_s
+
+        self.lock = threading.Lock()
+        self.frames_in = 0
+        self.frames_drawn = 0
+        self.pending_bands = None       # band count changed, realloc on GUI thread
+
+        layout = QVBoxLayout()
+        layout.setContentsMargins(0, 0, 0, 0)
+        self.plot = pg.PlotWidget(title="Spectre FFT")
+        self.plot.setYRange(floor_db, 0)
+        self.plot.setLabel('left', 'Amplitude (dB)')
+        self.plot.setLabel('bottom', 'Bandes')
+        self.plot.showGrid(x=True, y=True)
+        layout.addWidget(self.plot)
+
+        self.waterfall = pg.PlotWidget(title="Waterfall")
+        self.waterfall.setLabel('left', 'Frames')
+        self.waterfall.setLabel('bottom', 'Bandes')
+        self.image = pg.ImageItem(axisOrder='row-major')
+        self.image.setLookupTable(pg.colormap.get('viridis').getLookupTable(nPts=256))
+        self.waterfall.addItem(self.image)
+        layout.addWidget(self.waterfall)
+        self.setLayout(layout)
+
+        self._alloc(bands)
+
+        self.timer = QTimer(self)
+        self.timer.timeout.connect(self.render)
+        self.timer.start(max(1, int(1000 / fps)))
+
+    def _alloc(self, bands):
+        """(Re)create buffers and items for a given band count."""
+        self.bands = bands
+        self.ring = np.full((self.history, bands), self.floor_db, dtype=np.float32)
+        self.view = np.empty_like(self.ring)   # time-ordered copy for the image
+        self.head = 0                   # next row to write
+        self.dirty = False
+        self.latest = np.full(bands, self.floor_db, dtype=np.float32)
+        self.peak = np.full(bands, self.floor_db, dtype=np.float32)
+        self.peak_age = np.zeros(bands, dtype=np.float32)
+        self.last_tick = time.monotonic()
+        self.x = np.arange(bands, dtype=np.float32)
+
+        self.plot.clear()
+        self.bar = pg.BarGraphItem(x=self.x, height=self.latest - self.floor_db,
+                                   y0=self.floor_db, width=0.8, brush='cyan')
+        self.plot.addItem(self.bar)
+        self.peak_line = pg.PlotDataItem(self.x, self.peak, pen=None, symbol='t1',
+                                         symbolSize=10, symbolBrush='r')
+        self.plot.addItem(self.peak_line)
+        self.plot.setXRange(-0.5, bands - 0.5)
+
+        self.image.setImage(self.ring, levels=(self.floor_db, 0), autoLevels=False)
+        self.image.setRect(-0.5, 0, bands, self.history)
+
+    def push(self, frame):
+        """Store one spectrum frame (sequence of dB values). Thread-safe."""
+        with self.lock:
+            if len(frame) != self.bands:
+                self.pending_bands = len(frame)
+                return
+            row = self.ring[self.head]
+            row[:] = frame
+            self.head = (self.head + 1) % self.history
+            self.frames_in += 1
+            self.dirty = True
+
+    def render(self):
+        """Timer tick: advance the peaks, redraw items in place if new frames arrived."""
+        pending = self.pending_bands
+        if pending:
+            self.pending_bands = None
+            with self.lock:
+                self._alloc(pending)
+            return
+
+        now = time.monotonic()
+        dt = now - self.last_tick
+        self.last_tick = now
+
+        with self.lock:
+            fresh = self.dirty
+            if fresh:
+                self.dirty = False
+                h = self.head
+                self.latest[:] = self.ring[h - 1]
+                # oldest row at the bottom, newest at the top
+                n = self.history - h
+                self.view[:n] = self.ring[h:]
+                self.view[n:] = self.ring[:h]
+
+        prev = self.peak.copy()
+        self.peak_age += dt
+        decay = np.where(self.peak_age > self.peak_hold_s, self.peak_decay_db_s * dt, 0.0)
+        np.maximum(self.peak - decay, self.floor_db, out=self.peak)
+        hit = self.latest >= self.peak
+        self.peak[hit] = self.latest[hit]
+        self.peak_age[hit] = 0.0
+        if fresh or not np.array_equal(prev, self.peak):
+            self.peak_line.setData(self.x, self.peak)
+
+        if not fresh:
+            return
+        self.bar.setOpts(height=self.latest - self.floor_db)
+        self.image.setImage(self.view, autoLevels=False)
+        self.frames_drawn += 1
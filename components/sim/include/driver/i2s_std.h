@@ -0,0 +1,79 @@
+#pragma once
+// Virtual I2S standard-mode driver: same API subset as ESP-IDF, paced in
+// real time from a WAV file or a generator (see sim.h)
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+typedef struct sim_i2s_chan *i2s_chan_handle_t;
+
+typedef enum { I2S_NUM_0 = 0, I2S_NUM_1 = 1 } i2s_port_t;
+typedef enum { I2S_ROLE_MASTER = 0, I2S_ROLE_SLAVE } i2s_role_t;
+
+typedef enum {
+    I2S_DATA_BIT_WIDTH_8BIT  = 8,
+    I2S_DATA_BIT_WIDTH_16BIT = 16,
+    I2S_DATA_BIT_WIDTH_24BIT = 24,
+    I2S_DATA_BIT_WIDTH_32BIT = 32,
+} i2s_data_bit_width_t;
+
+typedef enum {
+    I2S_SLOT_BIT_WIDTH_AUTO  = 0,
+    I2S_SLOT_BIT_WIDTH_16BIT = 16,
+    I2S_SLOT_BIT_WIDTH_32BIT = 32,
+} i2s_slot_bit_width_t;
+
+typedef enum { I2S_SLOT_MODE_MONO = 1, I2S_SLOT_MODE_STEREO = 2 } i2s_slot_mode_t;
+typedef enum { I2S_STD_SLOT_LEFT = 1, I2S_STD_SLOT_RIGHT = 2, I2S_STD_SLOT_BOTH = 3 } i2s_std_slot_mask_t;
+
+#define I2S_GPIO_UNUSED  (-1)
+
+typedef struct {
+    i2s_port_t id;
+    i2s_role_t role;
+    uint32_t dma_desc_num;
+    uint32_t dma_frame_num;
+    bool auto_clear;
+} i2s_chan_config_t;
+
+#define I2S_CHANNEL_DEFAULT_CONFIG(i2s_num, i2s_role) { \
+    .id = (i2s_num), .role = (i2s_role), .dma_desc_num = 6, .dma_frame_num = 240, .auto_clear = false }
+
+typedef struct {
+    uint32_t sample_rate_hz;
+    int clk_src;
+    int mclk_multiple;
+} i2s_std_clk_config_t;
+
+#define I2S_STD_CLK_DEFAULT_CONFIG(rate) { .sample_rate_hz = (rate), .clk_src = 0, .mclk_multiple = 256 }
+
+typedef struct {
+    i2s_data_bit_width_t data_bit_width;
+    i2s_slot_bit_width_t slot_bit_width;
+    i2s_slot_mode_t slot_mode;
+    i2s_std_slot_mask_t slot_mask;
+    uint32_t ws_width;
+    bool ws_pol;
+    bool bit_shift;
+} i2s_std_slot_config_t;
+
+typedef struct {
+    int mclk, bclk, ws, dout, din;
+} i2s_std_gpio_config_t;
+
+typedef struct {
+    i2s_std_clk_config_t clk_cfg;
+    i2s_std_slot_config_t slot_cfg;
+    i2s_std_gpio_config_t gpio_cfg;
+} i2s_std_config_t;
+
+esp_err_t i2s_new_channel(const i2s_chan_config_t *cfg, i2s_chan_handle_t *tx, i2s_chan_handle_t *rx);
+esp_err_t i2s_channel_init_std_mode(i2s_chan_handle_t h, const i2s_std_config_t *cfg);
+esp_err_t i2s_channel_reconfig_std_clock(i2s_chan_handle_t h, const i2s_std_clk_config_t *clk);
+esp_err_t i2s_channel_enable(i2s_chan_handle_t h);
+esp_err_t i2s_channel_disable(i2s_chan_handle_t h);
+esp_err_t i2s_channel_preload_data(i2s_chan_handle_t h, const void *src, size_t size, size_t *loaded);
+esp_err_t i2s_channel_read(i2s_chan_handle_t h, void *dest, size_t size, size_t *bytes_read, uint32_t timeout_ms);
+esp_err_t i2s_channel_write(i2s_chan_handle_t h, const void *src, size_t size, size_t *bytes_written, uint32_t timeout_ms);
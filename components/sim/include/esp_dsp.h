@@ -0,0 +1,8 @@
+#pragma once
+// Portable C versions of the esp-dsp functions used by the firmware
+#include "esp_err.h"
+
+esp_err_t dsps_fft2r_init_fc32(float *fft_table_buff, int table_size);
+esp_err_t dsps_fft2r_fc32(float *data, int N);      // natural in, bit-reversed out
+esp_err_t dsps_bit_rev_fc32(float *data, int N);
+void dsps_wind_hann_f32(float *window, int len);
@@ -0,0 +1,26 @@
+#pragma once
+// Host simulation of the board, configured from the environment:
+//
+//   SIM_INPUT   I2S RX source: a 16-bit PCM WAV (looped, first channel,
+//               resampled to the current rate), "sine:<hz>:<dbfs>",
+//               "noise:<dbfs>" or "silence"           (default sine:1000:-20)
+//   SIM_OUTPUT  WAV file receiving the I2S TX stream  (default: discarded)
+//   SIM_UART    symlink created to the UART0 pseudo-terminal, e.g.
+//               /tmp/esp-audio so the GUI runs with --port /tmp/esp-audio
+//   SIM_LOAD    injected CPU load, "<percent>[@<priority>]" (default
+//               priority 11, just above the audio task)
+//   SIM_REPORT  seconds between deadline reports on stderr (default 5)
+#include <stdint.h>
+
+typedef struct {
+    uint32_t rx_blocks;
+    uint32_t rx_dropped;        // blocks overwritten before the task read them
+    uint32_t tx_blocks;
+    uint32_t tx_underruns;      // TX DMA ran dry: audible glitch on a board
+    uint32_t worst_late_us;     // worst TX lateness behind the DMA position
+} sim_i2s_stats_t;
+
+void sim_i2s_stats(sim_i2s_stats_t *s);
+
+// Load and report tasks, started once by the first I2S channel
+void sim_load_start(void);
@@ -0,0 +1,56 @@
+#include "esp_dsp.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+esp_err_t dsps_fft2r_init_fc32(float *fft_table_buff, int table_size)
+{
+    (void)fft_table_buff;
+    return (table_size > 0 && (table_size & (table_size - 1)) == 0) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+// Radix-2 decimation in frequency on interleaved re/im
+esp_err_t dsps_fft2r_fc32(float *data, int N)
+{
+    for (int len = N; len >= 2; len >>= 1) {
+        int half = len >> 1;
+        for (int k = 0; k < half; k++) {
+            float wr = cosf(2.0f * (float)M_PI * k / len);
+            float wi = -sinf(2.0f * (float)M_PI * k / len);
+            for (int i = k; i < N; i += len) {
+                float *a = &data[2 * i], *b = &data[2 * (i + half)];
+                float dr = a[0] - b[0], di = a[1] - b[1];
+                a[0] += b[0];
+                a[1] += b[1];
+                b[0] = dr * wr - di * wi;
+                b[1] = dr * wi + di * wr;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_bit_rev_fc32(float *data, int N)
+{
+    for (int i = 1, j = 0; i < N; i++) {
+        int bit = N >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j |= bit;
+        if (i < j) {
+            float tr = data[2 * i], ti = data[2 * i + 1];
+            data[2 * i] = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = tr;
+            data[2 * j + 1] = ti;
+        }
+    }
+    return ESP_OK;
+}
+
+void dsps_wind_hann_f32(float *window, int len)
+{
+    for (int i = 0; i < len; i++)
+        window[i] = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / (float)(len - 1));
+}
@@ -0,0 +1,365 @@
+#include "driver/i2s_std.h"
+#include "sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const char *TAG_SIM = "SIM_I2S";
+
+// One direction of a port. The DMA position is derived from the wall clock:
+// block k of a channel enabled at t0 completes at t0 + (k + 1) * period.
+struct sim_i2s_chan {
+    bool is_tx;
+    bool enabled;
+    uint32_t fs;
+    uint32_t frame_num;         // samples per DMA buffer
+    uint32_t desc_num;          // DMA buffers
+    int bits;                   // data bit width
+    int64_t t0;
+    int64_t period_us_q8;       // block period, 1/256 us
+    uint64_t index;             // next block to hand out (RX) / queue (TX)
+    uint32_t preloaded;         // TX blocks queued while disabled
+};
+
+// ---------------- RX source ----------------
+
+static struct {
+    enum { SRC_SINE, SRC_NOISE, SRC_SILENCE, SRC_WAV } kind;
+    float freq, amp;
+    double phase;
+    float *wav;
+    long wav_len;
+    uint32_t wav_fs;
+    double wav_pos;
+    uint32_t noise;
+} src;
+
+static FILE *out_wav;
+static uint32_t out_bytes;
+static uint32_t out_fs;
+
+static sim_i2s_stats_t stats;
+
+static float *load_wav(const char *path, long *len, uint32_t *fs)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+
+    uint8_t hdr[12], ck[8];
+    uint16_t fmt = 0, ch = 0, bits = 0;
+    float *out = NULL;
+    if (fread(hdr, 1, 12, f) != 12 || memcmp(hdr, "RIFF", 4) || memcmp(hdr + 8, "WAVE", 4)) goto done;
+
+    while (fread(ck, 1, 8, f) == 8) {
+        uint32_t size = ck[4] | ck[5] << 8 | ck[6] << 16 | (uint32_t)ck[7] << 24;
+        if (!memcmp(ck, "fmt ", 4)) {
+            uint8_t b[16];
+            if (size < 16 || fread(b, 1, 16, f) != 16) goto done;
+            fmt = b[0] | b[1] << 8;
+            ch = b[2] | b[3] << 8;
+            *fs = b[4] | b[5] << 8 | b[6] << 16 | (uint32_t)b[7] << 24;
+            bits = b[14] | b[15] << 8;
+            fseek(f, size - 16 + (size & 1), SEEK_CUR);
+        }
+        else if (!memcmp(ck, "data", 4)) {
+            if (fmt != 1 || bits != 16 || ch == 0) goto done;
+            *len = size / (2 * ch);
+            out = malloc(*len * sizeof(float));
+            for (long i = 0; out && i < *len; i++) {
+                int16_t s[8] = {0};
+                if (fread(s, 2, ch > 8 ? 8 : ch, f) == 0) { *len = i; break; }
+                if (ch > 8) fseek(f, 2 * (ch - 8), SEEK_CUR);
+                out[i] = s[0] / 32768.0f;
+            }
+            break;
+        }
+        else fseek(f, size + (size & 1), SEEK_CUR);
+    }
+done:
+    fclose(f);
+    return out;
+}
+
+static void source_init(void)
+{
+    const char *in = getenv("SIM_INPUT");
+    float hz = 1000.0f, db = -20.0f;
+    src.kind = SRC_SINE;
+    src.noise = 22222;
+
+    if (!in) {
+        // default tone
+    }
+    else if (sscanf(in, "sine:%f:%f", &hz, &db) >= 1) {
+        src.kind = SRC_SINE;
+    }
+    else if (sscanf(in, "noise:%f", &db) == 1) {
+        src.kind = SRC_NOISE;
+    }
+    else if (strcmp(in, "silence") == 0) {
+        src.kind = SRC_SILENCE;
+    }
+    else if ((src.wav = load_wav(in, &src.wav_len, &src.wav_fs)) && src.wav_len > 0) {
+        src.kind = SRC_WAV;
+        ESP_LOGI(TAG_SIM, "RX from %s (%ld samples @ %lu Hz, looped)", in, src.wav_len,
+                 (unsigned long)src.wav_fs);
+    }
+    else {
+        ESP_LOGE(TAG_SIM, "SIM_INPUT %s: not a 16-bit PCM WAV, using a 1 kHz sine", in);
+        hz = 1000.0f;
+        db = -20.0f;
+    }
+    src.freq = hz;
+    src.amp = powf(10.0f, db / 20.0f);
+}
+
+static float source_next(uint32_t fs)
+{
+    switch (src.kind) {
+        case SRC_SINE: {
+            float y = src.amp * (float)sin(src.phase);
+            src.phase += 2.0 * M_PI * src.freq / fs;
+            if (src.phase > 2.0 * M_PI) src.phase -= 2.0 * M_PI;
+            return y;
+        }
+        case SRC_NOISE:
+            src.noise = src.noise * 1664525u + 1013904223u;
+            return src.amp * ((int32_t)src.noise / 2147483648.0f);
+        case SRC_WAV: {
+            // linear interpolation, follows RATE switches
+            long i = (long)src.wav_pos;
+            float t = (float)(src.wav_pos - i);
+            float y = src.wav[i] + (src.wav[(i + 1) % src.wav_len] - src.wav[i]) * t;
+            src.wav_pos += (double)src.wav_fs / fs;
+            if (src.wav_pos >= src.wav_len) src.wav_pos -= src.wav_len;
+            return y;
+        }
+        default:
+            return 0.0f;
+    }
+}
+
+// ---------------- TX sink ----------------
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+// Header rewritten with every block so a killed simulator leaves a valid file
+static void sink_header(void)
+{
+    uint8_t h[44] = "RIFF----WAVEfmt ";
+    put_u32(h + 4, 36 + out_bytes);
+    put_u32(h + 16, 16);
+    h[20] = 1; h[22] = 1;                       // PCM, mono
+    put_u32(h + 24, out_fs);
+    put_u32(h + 28, out_fs * 2);
+    h[32] = 2; h[34] = 16;
+    memcpy(h + 36, "data", 4);
+    put_u32(h + 40, out_bytes);
+    fseek(out_wav, 0, SEEK_SET);
+    fwrite(h, 1, sizeof(h), out_wav);
+    fseek(out_wav, 0, SEEK_END);
+}
+
+static void sink_init(uint32_t fs)
+{
+    const char *path = getenv("SIM_OUTPUT");
+    if (!path) return;
+    out_wav = fopen(path, "wb");
+    if (!out_wav) { ESP_LOGE(TAG_SIM, "Cannot write %s", path); return; }
+    out_fs = fs;
+    sink_header();
+}
+
+static void sink_write(const void *data, size_t bytes, uint32_t fs)
+{
+    if (!out_wav) return;
+    if (fs != out_fs) {
+        // one file per rate would be more faithful; keep going and log it
+        ESP_LOGW(TAG_SIM, "SIM_OUTPUT header stays at %lu Hz, now %lu Hz",
+                 (unsigned long)out_fs, (unsigned long)fs);
+        out_fs = fs;
+    }
+    fwrite(data, 1, bytes, out_wav);
+    out_bytes += bytes;
+    sink_header();
+    fflush(out_wav);
+}
+
+// ---------------- clock ----------------
+
+static void set_rate(struct sim_i2s_chan *c, uint32_t fs)
+{
+    c->fs = fs;
+    c->period_us_q8 = ((int64_t)c->frame_num * 1000000 * 256) / fs;
+}
+
+// DMA blocks completed since enable
+static uint64_t dma_position(const struct sim_i2s_chan *c, int64_t now)
+{
+    return (uint64_t)(((now - c->t0) * 256) / c->period_us_q8);
+}
+
+static int64_t block_time(const struct sim_i2s_chan *c, uint64_t k)
+{
+    return c->t0 + (int64_t)((k * c->period_us_q8) / 256);
+}
+
+// FreeRTOS-friendly wait: a blocking sleep would stall the whole POSIX port
+static bool wait_until(int64_t t, int64_t limit)
+{
+    for (;;) {
+        int64_t now = esp_timer_get_time();
+        if (now >= t) return true;
+        if (now >= limit) return false;
+        vTaskDelay(1);
+    }
+}
+
+// ---------------- API ----------------
+
+esp_err_t i2s_new_channel(const i2s_chan_config_t *cfg, i2s_chan_handle_t *tx, i2s_chan_handle_t *rx)
+{
+    static bool started;
+    if (!started) {
+        started = true;
+        source_init();
+        sim_load_start();
+    }
+
+    for (int dir = 0; dir < 2; dir++) {
+        i2s_chan_handle_t *out = dir ? rx : tx;
+        if (!out) continue;
+        struct sim_i2s_chan *c = calloc(1, sizeof(*c));
+        if (!c) return ESP_ERR_NO_MEM;
+        c->is_tx = (dir == 0);
+        c->frame_num = cfg->dma_frame_num;
+        c->desc_num = cfg->dma_desc_num;
+        *out = c;
+    }
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_init_std_mode(i2s_chan_handle_t c, const i2s_std_config_t *cfg)
+{
+    if (!c || !cfg) return ESP_ERR_INVALID_ARG;
+    c->bits = cfg->slot_cfg.data_bit_width;
+    set_rate(c, cfg->clk_cfg.sample_rate_hz);
+    if (c->is_tx) sink_init(c->fs);
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_reconfig_std_clock(i2s_chan_handle_t c, const i2s_std_clk_config_t *clk)
+{
+    if (!c || !clk) return ESP_ERR_INVALID_ARG;
+    if (c->enabled) return ESP_ERR_INVALID_STATE;
+    set_rate(c, clk->sample_rate_hz);
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_enable(i2s_chan_handle_t c)
+{
+    if (!c || c->enabled) return ESP_ERR_INVALID_STATE;
+    c->t0 = esp_timer_get_time();
+    c->index = c->preloaded;
+    c->preloaded = 0;
+    c->enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_disable(i2s_chan_handle_t c)
+{
+    if (!c || !c->enabled) return ESP_ERR_INVALID_STATE;
+    c->enabled = false;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_preload_data(i2s_chan_handle_t c, const void *src_data, size_t size, size_t *loaded)
+{
+    if (!c || !c->is_tx || c->enabled) return ESP_ERR_INVALID_STATE;
+    size_t block = c->frame_num * (c->bits / 8);
+    size_t room = (c->desc_num - c->preloaded) * block;
+    size_t n = (size < room) ? size : room;
+    c->preloaded += n / block;
+    sink_write(src_data, n, c->fs);
+    *loaded = n;
+    return ESP_OK;
+}
+
+// Returns the next captured block once its DMA buffer is complete. A reader
+// more than desc_num blocks behind loses the oldest ones, like the real DMA.
+esp_err_t i2s_channel_read(i2s_chan_handle_t c, void *dest, size_t size, size_t *bytes_read,
+                           uint32_t timeout_ms)
+{
+    if (!c || c->is_tx || !c->enabled) return ESP_ERR_INVALID_STATE;
+    int64_t now = esp_timer_get_time();
+    int64_t limit = (timeout_ms == portMAX_DELAY) ? INT64_MAX : now + (int64_t)timeout_ms * 1000;
+
+    uint64_t done = dma_position(c, now);
+    if (done > c->index + c->desc_num) {
+        stats.rx_dropped += (uint32_t)(done - c->desc_num - c->index);
+        c->index = done - c->desc_num;
+    }
+    if (!wait_until(block_time(c, c->index + 1), limit)) {
+        *bytes_read = 0;
+        return ESP_ERR_TIMEOUT;
+    }
+
+    int width = c->bits / 8;
+    size_t n = size / width;
+    if (n > c->frame_num) n = c->frame_num;
+    for (size_t i = 0; i < n; i++) {
+        float x = fminf(fmaxf(source_next(c->fs), -1.0f), 1.0f);
+        if (width == 4) ((int32_t *)dest)[i] = (int32_t)(x * 8388607.0f) * 256;  // 24-bit left-justified
+        else            ((int16_t *)dest)[i] = (int16_t)(x * 32767.0f);
+    }
+    c->index++;
+    stats.rx_blocks++;
+    *bytes_read = n * width;
+    return ESP_OK;
+}
+
+// Queues one block behind the DMA position; blocks while all buffers are
+// full, counts an underrun when the DMA already played past it
+esp_err_t i2s_channel_write(i2s_chan_handle_t c, const void *src_data, size_t size,
+                            size_t *bytes_written, uint32_t timeout_ms)
+{
+    if (!c || !c->is_tx || !c->enabled) return ESP_ERR_INVALID_STATE;
+    int64_t now = esp_timer_get_time();
+    int64_t limit = (timeout_ms == portMAX_DELAY) ? INT64_MAX : now + (int64_t)timeout_ms * 1000;
+
+    uint64_t played = dma_position(c, now);
+    if (c->index < played) {
+        uint32_t late = (uint32_t)(now - block_time(c, c->index));
+        if (late > stats.worst_late_us) stats.worst_late_us = late;
+        stats.tx_underruns++;
+        c->index = played;
+    }
+    if (c->index >= played + c->desc_num &&
+        !wait_until(block_time(c, c->index - c->desc_num + 1), limit)) {
+        *bytes_written = 0;
+        return ESP_ERR_TIMEOUT;
+    }
+
+    sink_write(src_data, size, c->fs);
+    c->index++;
+    stats.tx_blocks++;
+    *bytes_written = size;
+    return ESP_OK;
+}
+
+void sim_i2s_stats(sim_i2s_stats_t *s)
+{
+    *s = stats;
+}
@@ -0,0 +1,62 @@
+#include "sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define LOAD_WINDOW_MS  10
+
+static const char *TAG_SIM = "SIM";
+
+static int load_pct;
+
+// Spins for load_pct of every window, above the audio task by default, so
+// it delays blocks the way a busy ISR or a higher-priority task would
+static void sim_load_task(void *arg)
+{
+    (void)arg;
+    for (;;) {
+        int64_t t = esp_timer_get_time();
+        int64_t busy = (int64_t)LOAD_WINDOW_MS * 10 * load_pct;    // us
+        while (esp_timer_get_time() - t < busy) { }
+        vTaskDelay(pdMS_TO_TICKS(LOAD_WINDOW_MS) * (100 - load_pct) / 100 + 1);
+    }
+}
+
+static void sim_report_task(void *arg)
+{
+    int period = (int)(intptr_t)arg;
+    sim_i2s_stats_t last = {0};
+
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(period * 1000));
+        sim_i2s_stats_t s;
+        sim_i2s_stats(&s);
+        fprintf(stderr, "SIM: rx %lu blocks (dropped %lu), tx %lu (underruns %lu, +%lu), "
+                        "worst late %lu us, load %d%%\n",
+                (unsigned long)s.rx_blocks, (unsigned long)s.rx_dropped,
+                (unsigned long)s.tx_blocks, (unsigned long)s.tx_underruns,
+                (unsigned long)(s.tx_underruns - last.tx_underruns),
+                (unsigned long)s.worst_late_us, load_pct);
+        last = s;
+    }
+}
+
+void sim_load_start(void)
+{
+    const char *load = getenv("SIM_LOAD");
+    const char *report = getenv("SIM_REPORT");
+    int prio = 11;
+    int period = report ? atoi(report) : 5;
+
+    if (load && sscanf(load, "%d@%d", &load_pct, &prio) >= 1 && load_pct > 0) {
+        if (load_pct > 95) load_pct = 95;
+        ESP_LOGW(TAG_SIM, "Injecting %d%% CPU load at priority %d", load_pct, prio);
+        xTaskCreatePinnedToCore(sim_load_task, "sim_load", 2048, NULL, prio, NULL, 1);
+    }
+    if (period > 0)
+        xTaskCreatePinnedToCore(sim_report_task, "sim_report", 3072, (void *)(intptr_t)period, 2, NULL, 0);
+}
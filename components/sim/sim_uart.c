@@ -0,0 +1,106 @@
+#define _GNU_SOURCE
+#include "driver/uart.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "esp_log.h"
+#include "freertos/task.h"
+
+static const char *TAG_SIM = "SIM_UART";
+
+static int master_fd = -1;
+static int slave_fd = -1;       // kept open so the master survives GUI reconnects
+
+esp_err_t uart_param_config(uart_port_t port, const uart_config_t *cfg)
+{
+    (void)port;
+    (void)cfg;
+    return ESP_OK;
+}
+
+esp_err_t uart_driver_install(uart_port_t port, int rx_buffer_size, int tx_buffer_size,
+                              int queue_size, void *uart_queue, int intr_alloc_flags)
+{
+    (void)rx_buffer_size; (void)tx_buffer_size; (void)queue_size;
+    (void)uart_queue; (void)intr_alloc_flags;
+    if (port != UART_NUM_0) return ESP_ERR_NOT_SUPPORTED;
+    if (master_fd >= 0) return ESP_OK;
+
+    master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master_fd < 0 || grantpt(master_fd) || unlockpt(master_fd)) return ESP_FAIL;
+    fcntl(master_fd, F_SETFL, fcntl(master_fd, F_GETFL) | O_NONBLOCK);
+
+    const char *name = ptsname(master_fd);
+    slave_fd = open(name, O_RDWR | O_NOCTTY);
+    if (slave_fd >= 0) {
+        struct termios t;
+        tcgetattr(slave_fd, &t);
+        cfmakeraw(&t);
+        tcsetattr(slave_fd, TCSANOW, &t);
+    }
+
+    const char *link = getenv("SIM_UART");
+    if (link) {
+        unlink(link);
+        if (symlink(name, link) == 0) name = link;
+        else ESP_LOGW(TAG_SIM, "Cannot link %s: %s", link, strerror(errno));
+    }
+    ESP_LOGW(TAG_SIM, "UART0 on %s  (python UI/GUI.py --port %s)", name, name);
+    return ESP_OK;
+}
+
+// A full pty buffer blocks the writer like the UART driver does (binary
+// dumps); nothing read for SIM_UART_STALL_MS and the output is dropped,
+// like an unplugged cable
+#define SIM_UART_STALL_MS  50
+
+int uart_write_bytes(uart_port_t port, const void *src, size_t size)
+{
+    (void)port;
+    const char *p = src;
+    size_t left = size;
+    TickType_t stalled = xTaskGetTickCount();
+    while (left > 0) {
+        ssize_t n = write(master_fd, p, left);
+        if (n > 0) {
+            p += n;
+            left -= n;
+            stalled = xTaskGetTickCount();
+            continue;
+        }
+        if (xTaskGetTickCount() - stalled >= pdMS_TO_TICKS(SIM_UART_STALL_MS)) break;
+        vTaskDelay(1);
+    }
+    return (int)size;
+}
+
+int uart_read_bytes(uart_port_t port, void *buf, uint32_t length, TickType_t ticks_to_wait)
+{
+    (void)port;
+    TickType_t start = xTaskGetTickCount();
+    for (;;) {
+        ssize_t n = read(master_fd, buf, length);
+        if (n > 0) return (int)n;
+        if (xTaskGetTickCount() - start >= ticks_to_wait) return 0;
+        vTaskDelay(1);      // a blocking read() would stall every task
+    }
+}
+
+esp_err_t uart_wait_tx_done(uart_port_t port, TickType_t ticks_to_wait)
+{
+    (void)port;
+    (void)ticks_to_wait;
+    return ESP_OK;
+}
+
+esp_err_t uart_set_baudrate(uart_port_t port, uint32_t baudrate)
+{
+    (void)port;
+    (void)baudrate;     // a pty has no line rate
+    return ESP_OK;
+}
@@ -0,0 +1,59 @@
+#include "audio_tap.h"
+
+void audio_tap_init(audio_tap_t *t)
+{
+    memset(t->buf, 0, sizeof(t->buf));
+    atomic_init(&t->head, 0u);
+}
+
+void audio_tap_reader_init(audio_tap_reader_t *r, audio_tap_t *t)
+{
+    r->tap = t;
+    r->cursor = atomic_load_explicit(&t->head, memory_order_acquire);
+    r->overruns = 0;
+}
+
+uint32_t audio_tap_available(const audio_tap_reader_t *r)
+{
+    uint32_t avail = atomic_load_explicit(&r->tap->head, memory_order_acquire) - r->cursor;
+    return (avail > AUDIO_TAP_SIZE) ? AUDIO_TAP_SIZE : avail;
+}
+
+static void audio_tap_resync(audio_tap_reader_t *r, uint32_t head)
+{
+    r->overruns++;
+    r->cursor = head - AUDIO_TAP_SIZE / 2;
+}
+
+// Samples more than this behind the published head may be under a write
+// that has not been published yet
+#define AUDIO_TAP_SAFE  (AUDIO_TAP_SIZE - AUDIO_TAP_WRITE_MAX)
+
+int audio_tap_read(audio_tap_reader_t *r, int16_t *out, int n)
+{
+    audio_tap_t *t = r->tap;
+    uint32_t head = atomic_load_explicit(&t->head, memory_order_acquire);
+    if (head - r->cursor > AUDIO_TAP_SAFE) audio_tap_resync(r, head);
+
+    uint32_t avail = head - r->cursor;
+    if ((uint32_t)n > avail) n = (int)avail;
+    if (n <= 0) return 0;
+
+    unsigned pos = r->cursor & (AUDIO_TAP_SIZE - 1);
+    unsigned first = AUDIO_TAP_SIZE - pos;
+    if (first > (unsigned)n) first = n;
+    memcpy(out, &t->buf[pos], first * sizeof(int16_t));
+    memcpy(out + first, t->buf, (n - first) * sizeof(int16_t));
+
+    // the writer may have lapped us while copying: the copy is ordered
+    // before the re-read, and a block in flight is covered by the margin
+    atomic_thread_fence(memory_order_acquire);
+    head = atomic_load_explicit(&t->head, memory_order_relaxed);
+    if (head - r->cursor > AUDIO_TAP_SAFE) {
+        audio_tap_resync(r, head);
+        return 0;
+    }
+
+    r->cursor += n;
+    return n;
+}
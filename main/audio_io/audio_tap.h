@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#define AUDIO_TAP_SIZE       4096   // samples, power of two (~85 ms at 48 kHz)
+#define AUDIO_TAP_WRITE_MAX  256    // largest audio_tap_write() (AUDIO_BLOCK_SIZE range)
+
+// Post-DSP broadcast ring: one writer (audio task), any number of readers,
+// each with its own cursor. The writer never waits; a reader that falls
+// within AUDIO_TAP_WRITE_MAX of a ring behind, where the next block is
+// already being copied over its samples, is resynchronised and counts an
+// overrun.
+typedef struct {
+    int16_t buf[AUDIO_TAP_SIZE];
+    atomic_uint head;           // total samples written
+} audio_tap_t;
+
+typedef struct {
+    audio_tap_t *tap;
+    uint32_t cursor;
+    uint32_t overruns;
+} audio_tap_reader_t;
+
+void audio_tap_init(audio_tap_t *t);
+
+static inline void audio_tap_write(audio_tap_t *t, const int16_t *x, int n)
+{
+    unsigned head = atomic_load_explicit(&t->head, memory_order_relaxed);
+    unsigned pos = head & (AUDIO_TAP_SIZE - 1);
+    unsigned first = AUDIO_TAP_SIZE - pos;
+    if (first > (unsigned)n) first = n;
+
+    memcpy(&t->buf[pos], x, first * sizeof(int16_t));
+    memcpy(t->buf, x + first, (n - first) * sizeof(int16_t));
+
+    atomic_store_explicit(&t->head, head + n, memory_order_release);
+}
+
+void audio_tap_reader_init(audio_tap_reader_t *r, audio_tap_t *t);
+uint32_t audio_tap_available(const audio_tap_reader_t *r);
+
+// Copies up to n samples, returns the count actually read
+int audio_tap_read(audio_tap_reader_t *r, int16_t *out, int n);
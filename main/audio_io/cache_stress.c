@@ -0,0 +1,47 @@
+#include "cache_stress.h"
+
+#if CONFIG_AUDIO_CACHE_STRESS
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define STRESS_MAP_BYTES  (1024 * 1024)
+#define STRESS_STRIDE     32            // one cache line per read
+
+static const char *TAG_STRESS = "STRESS";
+
+volatile bool cache_stress_on = false;
+
+// Sweeps the mapped app image so the code and rodata of the audio task keep
+// getting evicted; yields once per sweep for the idle task / watchdog
+void cache_stress_task(void *arg)
+{
+    const esp_partition_t *app = esp_partition_find_first(ESP_PARTITION_TYPE_APP,
+                                                          ESP_PARTITION_SUBTYPE_ANY, NULL);
+    const void *map;
+    esp_partition_mmap_handle_t handle;
+    size_t len = (app && app->size < STRESS_MAP_BYTES) ? app->size : STRESS_MAP_BYTES;
+
+    if (!app || esp_partition_mmap(app, 0, len, ESP_PARTITION_MMAP_DATA, &map, &handle) != ESP_OK) {
+        ESP_LOGE(TAG_STRESS, "Cannot map the app partition");
+        vTaskDelete(NULL);
+        return;
+    }
+
+    const volatile uint8_t *p = (const volatile uint8_t *)map;
+    uint32_t sink = 0;
+
+    for (;;)
+    {
+        if (!cache_stress_on) {
+            vTaskDelay(pdMS_TO_TICKS(50));
+            continue;
+        }
+        for (size_t off = 0; off < len; off += STRESS_STRIDE)
+            sink += p[off];
+        vTaskDelay(1);
+    }
+    (void)sink;
+}
+#endif
@@ -0,0 +1,9 @@
+#pragma once
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+// Flash cache thrasher for worst-case block timing (CONFIG_AUDIO_CACHE_STRESS)
+#if CONFIG_AUDIO_CACHE_STRESS
+extern volatile bool cache_stress_on;
+void cache_stress_task(void *arg);
+#endif
@@ -0,0 +1,223 @@
+#include "capture.h"
+#include "config.h"
+#include <stdio.h>
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "uart_interface.h"
+
+static const char *TAG_CAP = "CAPTURE";
+
+// Dump frame types, framing in uart_write_frame()
+#define FRAME_HEADER    0x01
+#define FRAME_BLOCK     0x02
+#define FRAME_END       0x03
+#define FRAME_MAX       (7 + CAPTURE_BLOCK * 3 + CAPTURE_BLOCK * 2)
+
+const char *capture_state_to_str(capture_state_t s)
+{
+    switch (s) {
+        case CAPTURE_IDLE:      return "IDLE";
+        case CAPTURE_ARMED:     return "ARMED";
+        case CAPTURE_TRIGGERED: return "TRIGGERED";
+        case CAPTURE_FROZEN:    return "FROZEN";
+        case CAPTURE_DUMPING:   return "DUMPING";
+        default:                return "Unknown";
+    }
+}
+
+esp_err_t capture_init(capture_t *c, uint32_t fs, float post_fraction)
+{
+    if (!c) return ESP_ERR_INVALID_ARG;
+    memset(c, 0, sizeof(*c));
+    atomic_init(&c->head, 0u);
+    atomic_init(&c->tail, 0u);
+
+    size_t bytes = CAPTURE_PSRAM_BYTES;
+    c->ring = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    c->in_psram = (c->ring != NULL);
+    if (!c->ring) {
+        bytes = CAPTURE_INTERNAL_BYTES;
+        c->ring = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    if (!c->ring) {
+        ESP_LOGE(TAG_CAP, "No memory for capture buffer");
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (post_fraction < 0.0f) post_fraction = 0.0f;
+    if (post_fraction > 0.9f) post_fraction = 0.9f;
+
+    c->capacity = bytes / sizeof(capture_record_t);
+    c->post_blocks = (uint32_t)(c->capacity * post_fraction);
+    c->fs = c->next_fs = fs;
+    c->state = CAPTURE_IDLE;
+
+    ESP_LOGI(TAG_CAP, "%lu blocks (%.1f s) in %s", (unsigned long)c->capacity,
+             (float)c->capacity * CAPTURE_BLOCK / fs, c->in_psram ? "PSRAM" : "internal RAM");
+    return ESP_OK;
+}
+
+void capture_arm(capture_t *c, uint8_t mode)
+{
+    c->arm_request = CAPTURE_ARM_REQ | mode;
+}
+
+void capture_trigger(capture_t *c)
+{
+    c->manual_request = true;
+}
+
+void capture_request_dump(capture_t *c, int baud)
+{
+    c->dump_baud = (baud > 0) ? baud : -1;     // -1: keep the current baud rate
+}
+
+// A frozen capture keeps its rate for the dump; a recording one restarts
+void capture_set_sample_rate(capture_t *c, uint32_t fs)
+{
+    c->next_fs = fs;
+    if (c->state == CAPTURE_ARMED || c->state == CAPTURE_TRIGGERED)
+        capture_arm(c, c->mode);
+}
+
+// ---------------- capture task (core 0) ----------------
+
+static void capture_fire(capture_t *c, uint8_t reason)
+{
+    c->reason = reason;
+    c->trigger_index = (c->written > 0) ? c->written - 1 : 0;
+    c->state = CAPTURE_TRIGGERED;
+    ESP_LOGW(TAG_CAP, "Triggered (0x%02x) at block %lu", reason, (unsigned long)c->trigger_index);
+}
+
+static void capture_freeze(capture_t *c)
+{
+    c->recording = false;
+    c->state = CAPTURE_FROZEN;
+}
+
+static void capture_store(capture_t *c, const capture_record_t *r)
+{
+    if (c->state != CAPTURE_ARMED && c->state != CAPTURE_TRIGGERED) return;
+    if (r->epoch != c->epoch) return;               // staged before the last arm
+
+    memcpy(&c->ring[c->written % c->capacity], r, sizeof(*r));
+    c->written++;
+
+    uint8_t hit = r->events & c->mode;
+    if (c->state == CAPTURE_ARMED && hit)
+        capture_fire(c, hit & (uint8_t)-hit);       // lowest set source
+
+    if (c->state == CAPTURE_TRIGGERED && c->written - c->trigger_index > c->post_blocks)
+        capture_freeze(c);
+}
+
+static void put_u16(uint8_t *p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+static void put_u32(uint8_t *p, uint32_t v) { p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24; }
+
+static void capture_dump(capture_t *c, int baud)
+{
+    static uint8_t frame[FRAME_MAX];
+
+    uint32_t count = (c->written < c->capacity) ? c->written : c->capacity;
+    uint32_t first = c->written - count;
+    uint32_t trig  = (c->reason && c->trigger_index >= first) ? c->trigger_index - first : 0xFFFFFFFFu;
+
+    uart_tx_lock();
+    if (baud > 0) {
+        char msg[48];
+        int n = snprintf(msg, sizeof(msg), "CAPTURE:BAUD=%d\r\n", baud);
+        uart_write_raw(msg, n);
+        uart_set_link_baud(baud);
+        vTaskDelay(pdMS_TO_TICKS(100));     // let the host follow
+    }
+
+    // header
+    frame[0] = 1;                           // format version
+    put_u32(&frame[1], c->fs);
+    put_u16(&frame[5], CAPTURE_BLOCK);
+    put_u32(&frame[7], count);
+    put_u32(&frame[11], trig);
+    frame[15] = c->reason;
+    put_u32(&frame[16], c->dropped);
+    uart_write_frame(FRAME_HEADER, frame, 20);
+
+    // blocks: pre tap packed to 24 bits, post tap as-is
+    for (uint32_t i = 0; i < count; i++) {
+        const capture_record_t *r = &c->ring[(first + i) % c->capacity];
+        int n = r->n;
+        put_u32(&frame[0], r->seq);
+        frame[4] = r->events;
+        put_u16(&frame[5], (uint16_t)n);
+        uint8_t *p = &frame[7];
+        for (int k = 0; k < n; k++) {
+            int32_t s = r->pre[k] >> 8;
+            *p++ = s; *p++ = s >> 8; *p++ = s >> 16;
+        }
+        for (int k = 0; k < n; k++) {
+            put_u16(p, (uint16_t)r->post[k]);
+            p += 2;
+        }
+        uart_write_frame(FRAME_BLOCK, frame, (uint16_t)(p - frame));
+    }
+
+    put_u32(&frame[0], count);
+    uart_write_frame(FRAME_END, frame, 4);
+
+    if (baud > 0) uart_set_link_baud(0);
+    uart_tx_unlock();
+}
+
+void capture_task(void *arg)
+{
+    capture_t *c = (capture_t *)arg;
+
+    for (;;)
+    {
+        // (re)arm: restart the history from an empty ring. The staging ring
+        // stays with the audio task, which may be mid-push: blocks it staged
+        // under the previous epoch drain as usual and are dropped
+        int req = c->arm_request;
+        if (req) {
+            c->arm_request = 0;
+            c->epoch++;
+            c->mode = (uint8_t)(req & 0xFF);
+            c->fs = c->next_fs;
+            c->written = 0;
+            c->reason = 0;
+            c->manual_request = false;
+            c->state = CAPTURE_ARMED;
+            c->recording = true;
+        }
+
+        // move staged blocks into the history ring
+        unsigned head = atomic_load_explicit(&c->head, memory_order_acquire);
+        unsigned tail = atomic_load_explicit(&c->tail, memory_order_relaxed);
+        while (tail != head) {
+            capture_store(c, &c->staging[tail % CAPTURE_STAGING_SLOTS]);
+            tail++;
+            atomic_store_explicit(&c->tail, tail, memory_order_release);
+        }
+
+        if (c->manual_request) {
+            c->manual_request = false;
+            if (c->state == CAPTURE_ARMED) capture_fire(c, CAPTURE_TRIG_MANUAL);
+        }
+
+        int baud = c->dump_baud;
+        if (baud) {
+            c->dump_baud = 0;
+            if (c->state == CAPTURE_ARMED || c->state == CAPTURE_TRIGGERED)
+                capture_freeze(c);          // dump what we have so far
+            if (c->state == CAPTURE_FROZEN) {
+                c->state = CAPTURE_DUMPING;
+                capture_dump(c, baud);
+                c->state = CAPTURE_FROZEN;
+            }
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
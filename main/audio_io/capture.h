@@ -0,0 +1,98 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <string.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#define CAPTURE_BLOCK          CONFIG_AUDIO_BLOCK_SIZE  // samples per record (one I2S block)
+#define CAPTURE_STAGING_SLOTS  16           // audio task → capture task hand-off
+#define CAPTURE_PSRAM_BYTES    (2 * 1024 * 1024)
+#define CAPTURE_INTERNAL_BYTES (48 * 1024)  // fallback without PSRAM
+
+// Trigger sources (bit mask), also used as per-block event flags
+#define CAPTURE_TRIG_MANUAL    0x01
+#define CAPTURE_TRIG_CLIP      0x02
+#define CAPTURE_TRIG_DEADLINE  0x04
+#define CAPTURE_ARM_REQ        0x100
+
+typedef enum {
+    CAPTURE_IDLE = 0,
+    CAPTURE_ARMED,          // recording history, waiting for a trigger
+    CAPTURE_TRIGGERED,      // recording the post-trigger part
+    CAPTURE_FROZEN,         // buffer complete, ready to dump
+    CAPTURE_DUMPING
+} capture_state_t;
+
+// One block of both taps, same layout in staging and in the ring
+typedef struct {
+    uint32_t seq;
+    uint16_t n;
+    uint8_t  events;        // CAPTURE_TRIG_* seen in this block
+    uint8_t  epoch;         // arm generation it was staged under
+    int32_t  pre[CAPTURE_BLOCK];    // raw I2S RX words (24-bit left-justified)
+    int16_t  post[CAPTURE_BLOCK];   // samples sent to the amplifier
+} capture_record_t;
+
+typedef struct {
+    // staging ring, single producer (audio task) / single consumer (capture task)
+    capture_record_t staging[CAPTURE_STAGING_SLOTS];
+    atomic_uint head;
+    atomic_uint tail;
+    uint32_t seq;
+    uint32_t dropped;
+
+    // history ring (PSRAM when available)
+    capture_record_t *ring;
+    uint32_t capacity;      // records
+    uint32_t written;       // total records written since arm
+    uint32_t trigger_index;
+    uint32_t post_blocks;
+    bool in_psram;
+
+    uint32_t fs;            // rate of the recorded history
+    volatile uint32_t next_fs;  // taken on the next arm
+    volatile uint8_t epoch; // arm generation, stamped on each block by the audio task
+    uint8_t mode;           // enabled CAPTURE_TRIG_* sources
+    uint8_t reason;         // source that fired
+    volatile bool recording;
+    volatile capture_state_t state;
+    volatile bool manual_request;
+    volatile int arm_request;   // > 0: (mode | CAPTURE_ARM_REQ)
+    volatile int dump_baud; // > 0: dump requested at this baud rate
+} capture_t;
+
+esp_err_t capture_init(capture_t *c, uint32_t fs, float post_fraction);
+
+// Audio task: one block of both taps, a memcpy into internal RAM
+static inline void capture_push(capture_t *c, const int32_t *pre, const int16_t *post,
+                                int n, uint8_t events)
+{
+    if (!c->recording) return;
+
+    unsigned head = atomic_load_explicit(&c->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&c->tail, memory_order_acquire);
+    if (head - tail >= CAPTURE_STAGING_SLOTS) { c->dropped++; return; }
+
+    if (n > CAPTURE_BLOCK) n = CAPTURE_BLOCK;
+    capture_record_t *r = &c->staging[head % CAPTURE_STAGING_SLOTS];
+    r->seq = c->seq++;
+    r->n = (uint16_t)n;
+    r->events = events;
+    r->epoch = c->epoch;
+    memcpy(r->pre, pre, n * sizeof(int32_t));
+    memcpy(r->post, post, n * sizeof(int16_t));
+
+    atomic_store_explicit(&c->head, head + 1, memory_order_release);
+}
+
+// Control side
+void capture_arm(capture_t *c, uint8_t mode);
+void capture_trigger(capture_t *c);
+void capture_request_dump(capture_t *c, int baud);
+void capture_set_sample_rate(capture_t *c, uint32_t fs);
+const char *capture_state_to_str(capture_state_t s);
+
+void capture_task(void *arg);
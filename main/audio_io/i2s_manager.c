@@ -9,16 +9,16 @@ static i2s_chan_handle_t tx_chan;
 i2s_chan_handle_t get_rx_channel(void) { return rx_chan; }
 i2s_chan_handle_t get_tx_channel(void) { return tx_chan; }
 
-void i2s_init_rx(void)
+void i2s_init_rx(uint32_t fs)
 {
     ESP_LOGI(TAG, "I2S RX Initialisation...");
     i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_PORT_RX, I2S_ROLE_MASTER);
-    chan_cfg.dma_frame_num = 128;   
+    chan_cfg.dma_frame_num = I2S_BLOCK;
     chan_cfg.dma_desc_num  = 3;
     ESP_ERROR_CHECK(i2s_new_channel(&chan_cfg, NULL, &rx_chan));
 
     i2s_std_config_t cfg_rx = {
-        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(I2S_SR),
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(fs),
         .slot_cfg = {
             .data_bit_width = I2S_DATA_BIT_WIDTH_32BIT,
             .slot_bit_width = I2S_SLOT_BIT_WIDTH_32BIT,
@@ -39,16 +39,16 @@ void i2s_init_rx(void)
     ESP_ERROR_CHECK(i2s_channel_enable(rx_chan));
 }
 
-void i2s_init_tx(void)
+void i2s_init_tx(uint32_t fs)
 {
     ESP_LOGI(TAG, "I2S TX Initialisation...");
     i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_PORT_TX, I2S_ROLE_MASTER);
-    chan_cfg.dma_frame_num = 128;   
+    chan_cfg.dma_frame_num = I2S_BLOCK;
     chan_cfg.dma_desc_num  = 3;
     ESP_ERROR_CHECK(i2s_new_channel(&chan_cfg, &tx_chan, NULL));
 
     i2s_std_config_t cfg_tx = {
-        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(I2S_SR),
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(fs),
         .slot_cfg = {
             .data_bit_width = I2S_DATA_BIT_WIDTH_16BIT,
             .slot_bit_width = I2S_SLOT_BIT_WIDTH_16BIT,
@@ -68,3 +68,28 @@ void i2s_init_tx(void)
     ESP_ERROR_CHECK(i2s_channel_init_std_mode(tx_chan, &cfg_tx));
     ESP_ERROR_CHECK(i2s_channel_enable(tx_chan));
 }
+
+esp_err_t i2s_set_sample_rate(uint32_t fs)
+{
+    static const int16_t silence[I2S_BLOCK] = {0};
+    i2s_std_clk_config_t clk = I2S_STD_CLK_DEFAULT_CONFIG(fs);
+    size_t loaded;
+    esp_err_t err;
+
+    i2s_channel_disable(tx_chan);
+    i2s_channel_disable(rx_chan);
+
+    err = i2s_channel_reconfig_std_clock(rx_chan, &clk);
+    if (err == ESP_OK) err = i2s_channel_reconfig_std_clock(tx_chan, &clk);
+
+    // stale DMA content would be replayed at the new rate
+    for (int i = 0; i < 3; i++)
+        i2s_channel_preload_data(tx_chan, silence, sizeof(silence), &loaded);
+
+    // re-enable even on failure, the loop must keep running at the old rate
+    ESP_ERROR_CHECK(i2s_channel_enable(rx_chan));
+    ESP_ERROR_CHECK(i2s_channel_enable(tx_chan));
+
+    if (err == ESP_OK) ESP_LOGI(TAG, "I2S sample rate %lu Hz", (unsigned long)fs);
+    return err;
+}
@@ -3,8 +3,12 @@
 #include "driver/i2s_std.h"
 
 
-void i2s_init_rx(void);
-void i2s_init_tx(void);
+void i2s_init_rx(uint32_t fs);
+void i2s_init_tx(uint32_t fs);
+
+// Stops both channels, switches their clocks, primes TX with silence and
+// restarts them. Call from the audio task (the only reader/writer).
+esp_err_t i2s_set_sample_rate(uint32_t fs);
 
 i2s_chan_handle_t get_rx_channel(void);
 i2s_chan_handle_t get_tx_channel(void);
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "monitor_stream.h"
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "uart_interface.h"
+#include "dsp_math.h"
+
+#define MONITOR_CHUNK  128      // tap samples per decimation pass
+#define MONITOR_LINE   (40 + (MONITOR_FRAME_SAMPLES / 2 + 2) / 3 * 4)
+
+_Static_assert(MONITOR_LINE <= TXQ_MSG_MAX, "MON: line must fit one TX queue message");
+
+static const char b64_chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static int base64_encode(const uint8_t *in, int len, char *out)
+{
+    int o = 0;
+    for (int i = 0; i < len; i += 3) {
+        uint32_t v = in[i] << 16;
+        if (i + 1 < len) v |= in[i + 1] << 8;
+        if (i + 2 < len) v |= in[i + 2];
+        out[o++] = b64_chars[(v >> 18) & 0x3F];
+        out[o++] = b64_chars[(v >> 12) & 0x3F];
+        out[o++] = (i + 1 < len) ? b64_chars[(v >> 6) & 0x3F] : '=';
+        out[o++] = (i + 2 < len) ? b64_chars[v & 0x3F] : '=';
+    }
+    return o;
+}
+
+void monitor_init(monitor_t *m, audio_tap_t *tap, uint32_t fs)
+{
+    memset(m, 0, sizeof(*m));
+    audio_tap_reader_init(&m->reader, tap);
+    m->fs = fs;
+    halfband_design();
+}
+
+void monitor_enable(monitor_t *m, bool on, int rate)
+{
+    m->request_rate = on ? ((rate > 0) ? rate : MONITOR_DEFAULT_RATE) : -1;
+}
+
+// Restarts a running stream so the decimation matches the new input rate
+void monitor_set_input_rate(monitor_t *m, uint32_t fs)
+{
+    m->fs = fs;
+    if (m->enabled) m->request_rate = m->requested;
+}
+
+static void monitor_configure(monitor_t *m, int rate)
+{
+    if (rate > MONITOR_MAX_RATE) rate = MONITOR_MAX_RATE;
+
+    // smallest power-of-two decimation that gets at or below the requested rate
+    int stages = 0;
+    while (stages < MONITOR_MAX_STAGES && (m->fs >> stages) > (uint32_t)rate)
+        stages++;
+
+    m->stages = stages;
+    m->requested = rate;
+    m->rate = m->fs >> stages;
+    for (int s = 0; s < MONITOR_MAX_STAGES; s++) halfband_reset(&m->hb[s]);
+    adpcm_reset(&m->adpcm);
+    audio_tap_reader_init(&m->reader, m->reader.tap);
+    m->fill = 0;
+    m->enabled = true;
+}
+
+// MON:<seq>,<rate>,<predictor>,<index>,<base64 adpcm>
+static void monitor_send_frame(monitor_t *m)
+{
+    uint8_t adpcm[MONITOR_FRAME_SAMPLES / 2];
+    char line[MONITOR_LINE];
+
+    int pred = m->adpcm.predictor;
+    int index = m->adpcm.index;
+    size_t bytes = adpcm_encode(&m->adpcm, m->frame, MONITOR_FRAME_SAMPLES, adpcm);
+
+    int n = snprintf(line, sizeof(line), "MON:%lu,%lu,%d,%d,",
+                     (unsigned long)m->seq++, (unsigned long)m->rate, pred, index);
+    n += base64_encode(adpcm, (int)bytes, line + n);
+    line[n++] = '\r';
+    line[n++] = '\n';
+
+    uart_send(TXQ_LOW, line, n);       // dropped rather than delaying replies
+}
+
+static void monitor_process(monitor_t *m, const int16_t *in, int n)
+{
+    float a[MONITOR_CHUNK], b[MONITOR_CHUNK / 2];
+    for (int i = 0; i < n; i++) a[i] = in[i] * (1.0f / 32768.0f);
+
+    float *x = a, *y = b;
+    for (int s = 0; s < m->stages; s++) {
+        n = halfband_decimate(&m->hb[s], x, n, y);
+        float *t = x; x = y; y = t;         // ping-pong, outputs shrink each stage
+    }
+
+    for (int i = 0; i < n; i++) {
+        float v = dsp_clampf(x[i], -1.0f, 1.0f);
+        m->frame[m->fill++] = (int16_t)(v * 32767.0f);
+        if (m->fill == MONITOR_FRAME_SAMPLES) {
+            monitor_send_frame(m);
+            m->fill = 0;
+        }
+    }
+}
+
+void monitor_task(void *arg)
+{
+    monitor_t *m = (monitor_t *)arg;
+    int16_t chunk[MONITOR_CHUNK];
+
+    for (;;)
+    {
+        int req = m->request_rate;
+        if (req) {
+            m->request_rate = 0;
+            if (req > 0) monitor_configure(m, req);
+            else         m->enabled = false;
+        }
+
+        if (!m->enabled || audio_tap_available(&m->reader) < MONITOR_CHUNK) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
+
+        int n = audio_tap_read(&m->reader, chunk, MONITOR_CHUNK);
+        if (n == MONITOR_CHUNK) monitor_process(m, chunk, n);
+    }
+}
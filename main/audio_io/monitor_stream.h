@@ -0,0 +1,32 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_tap.h"
+#include "halfband.h"
+#include "adpcm.h"
+
+#define MONITOR_MAX_STAGES     3        // 48 kHz → 24 / 12 / 6 kHz
+#define MONITOR_FRAME_SAMPLES  256      // decimated samples per MON: line
+#define MONITOR_DEFAULT_RATE   8000
+#define MONITOR_MAX_RATE       8000     // ~0.77 B/sample on the wire, 115200 baud carries ~11.5 KB/s
+
+// Decimated IMA-ADPCM monitor of the post-DSP signal, encoded on core 0
+typedef struct {
+    audio_tap_reader_t reader;
+    halfband_t hb[MONITOR_MAX_STAGES];
+    adpcm_state_t adpcm;
+    uint32_t fs;
+    int stages;
+    uint32_t rate;              // output sample rate
+    int requested;              // rate asked for by the last MONITOR ON
+    volatile bool enabled;
+    volatile int request_rate;  // > 0: (re)start at this rate, < 0: stop
+    uint32_t seq;
+    int fill;
+    int16_t frame[MONITOR_FRAME_SAMPLES];
+} monitor_t;
+
+void monitor_init(monitor_t *m, audio_tap_t *tap, uint32_t fs);
+void monitor_enable(monitor_t *m, bool on, int rate);
+void monitor_set_input_rate(monitor_t *m, uint32_t fs);     // after a RATE switch
+void monitor_task(void *arg);
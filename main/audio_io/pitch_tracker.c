@@ -0,0 +1,122 @@
+#include "pitch_tracker.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "subscription.h"
+#include "trace.h"
+#include "rtos_wait.h"
+
+#define PITCH_CHUNK    128      // tap samples per pitch_process() call
+#define PITCH_BACKLOG  (AUDIO_TAP_SIZE / 2)
+
+void pitch_tracker_init(pitch_tracker_t *t, audio_tap_t *tap, uint32_t fs)
+{
+    memset(t, 0, sizeof(*t));
+    audio_tap_reader_init(&t->reader, tap);
+    atomic_init(&t->seq, 0u);
+    pitch_init(&t->pitch, (float)fs, PITCH_HOP_MS);
+}
+
+void pitch_tracker_set_hop(pitch_tracker_t *t, float hop_ms)
+{
+    t->request_hop = hop_ms;
+}
+
+void pitch_tracker_set_input_rate(pitch_tracker_t *t, uint32_t fs)
+{
+    t->request_fs = fs;
+}
+
+static void pitch_tracker_publish(pitch_tracker_t *t)
+{
+    const pitch_t *p = &t->pitch;
+
+    // seqlock write: odd sequence while the result is inconsistent
+    unsigned s = atomic_load_explicit(&t->seq, memory_order_relaxed);
+    atomic_store_explicit(&t->seq, s + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    t->result.f0_hz   = p->f0;
+    t->result.clarity = p->clarity;
+    t->result.voiced  = p->voiced;
+    t->result.seq     = p->frames;
+
+    atomic_store_explicit(&t->seq, s + 2, memory_order_release);
+}
+
+bool pitch_tracker_read(pitch_tracker_t *t, pitch_result_t *out)
+{
+    unsigned s1, s2;
+    do {
+        s1 = atomic_load_explicit(&t->seq, memory_order_acquire);
+        if (s1 & 1u) continue;                  // writer in progress
+        *out = t->result;
+        atomic_thread_fence(memory_order_acquire);
+        s2 = atomic_load_explicit(&t->seq, memory_order_relaxed);
+        if (s1 == s2) break;
+    } while (1);
+
+    return s1 != 0;
+}
+
+// Fixed cost per analysis: two PITCH_FFT-point FFTs and O(PITCH_WINDOW)
+// around them, at most one per chunk. A tracker that falls half a tap
+// behind drops the backlog and restarts on the live signal.
+void pitch_tracker_task(void *arg)
+{
+    pitch_tracker_t *t = (pitch_tracker_t *)arg;
+    int16_t chunk[PITCH_CHUNK];
+    float x[PITCH_CHUNK];
+
+    for (;;)
+    {
+        uint32_t fs = t->request_fs;
+        if (fs) {
+            t->request_fs = 0;
+            pitch_set_sample_rate(&t->pitch, (float)fs);
+        }
+        float hop = t->request_hop;
+        if (hop > 0.0f) {
+            t->request_hop = 0.0f;
+            pitch_set_hop(&t->pitch, hop);
+        }
+
+        if (!sub_rate(SUB_PITCH)) {
+            t->active = false;
+            vTaskDelay(pdMS_TO_TICKS(50));
+            continue;
+        }
+        uint32_t avail = audio_tap_available(&t->reader);
+        if (t->active && avail >= PITCH_BACKLOG) {
+            t->late++;
+            t->active = false;
+        }
+        if (!t->active) {
+            // start from the live signal, not what the tap held meanwhile
+            audio_tap_reader_init(&t->reader, t->reader.tap);
+            avail = 0;
+            pitch_set_sample_rate(&t->pitch, t->pitch.fs);
+            t->active = true;
+        }
+
+        if (avail < PITCH_CHUNK) {
+            vTaskDelay(ms_to_ticks_ceil(5));
+            continue;
+        }
+        if (audio_tap_read(&t->reader, chunk, PITCH_CHUNK) != PITCH_CHUNK) continue;
+        for (int i = 0; i < PITCH_CHUNK; i++) x[i] = chunk[i] * (1.0f / 32768.0f);
+
+        TRACE_BEGIN(TRACE_PITCH);
+        int64_t t0 = esp_timer_get_time();
+        bool done = pitch_process(&t->pitch, x, PITCH_CHUNK);
+        uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+        TRACE_END(TRACE_PITCH);
+        if (!done) continue;
+
+        t->us_last = us;
+        if (us > t->us_max) t->us_max = us;
+        if (us > PITCH_BUDGET_US) t->over_budget++;
+        pitch_tracker_publish(t);
+    }
+}
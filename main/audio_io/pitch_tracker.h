@@ -0,0 +1,42 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "audio_tap.h"
+#include "pitch.h"
+
+#define PITCH_BUDGET_US  2000       // per analysis, core 0
+
+typedef struct {
+    float f0_hz;                // 0 when unvoiced
+    float clarity;
+    bool voiced;
+    uint32_t seq;               // analysis counter
+} pitch_result_t;
+
+// F0 of the post-DSP signal, tracked on core 0 while the PITCH telemetry
+// stream has a subscriber
+typedef struct {
+    audio_tap_reader_t reader;
+    pitch_t pitch;
+    bool active;
+    volatile uint32_t request_fs;   // > 0: restart at this input rate
+    volatile float request_hop;     // > 0: new hop in ms
+
+    // lock-free exchange (seqlock: single writer, any number of readers)
+    atomic_uint seq;
+    pitch_result_t result;
+
+    volatile uint32_t us_last;      // last analysis, decimation included
+    volatile uint32_t us_max;       // worst case since the last PITCH read
+    volatile uint32_t over_budget;  // analyses over PITCH_BUDGET_US
+    volatile uint32_t late;         // backlogs dropped
+} pitch_tracker_t;
+
+void pitch_tracker_init(pitch_tracker_t *t, audio_tap_t *tap, uint32_t fs);
+void pitch_tracker_set_hop(pitch_tracker_t *t, float hop_ms);
+void pitch_tracker_set_input_rate(pitch_tracker_t *t, uint32_t fs);    // after a RATE switch
+
+// Safe from any task. Returns false until the first analysis.
+bool pitch_tracker_read(pitch_tracker_t *t, pitch_result_t *out);
+void pitch_tracker_task(void *arg);
@@ -0,0 +1,216 @@
+#include "trace.h"
+
+#if CONFIG_AUDIO_TRACE
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "trace_hooks.h"
+#include "pipeline.h"
+#include "uart_interface.h"
+
+#define TRACE_EVENTS      CONFIG_AUDIO_TRACE_EVENTS
+#define TRACE_CORES       portNUM_PROCESSORS
+#define TRACE_MAX_TASKS   32
+#define TRACE_CHUNK       64            // events per frame
+
+_Static_assert((TRACE_EVENTS & (TRACE_EVENTS - 1)) == 0, "AUDIO_TRACE_EVENTS must be a power of two");
+
+// Dump frame types, framing in uart_write_frame()
+#define FRAME_TRACE_HEADER  0x10
+#define FRAME_TRACE_NAME    0x11
+#define FRAME_TRACE_EVENTS  0x12
+#define FRAME_TRACE_END     0x13
+
+// Written only from its own core; an interrupt (task switch) landing
+// between two writes gets the next slot, the host sorts by timestamp.
+// `writers` counts trace_put() calls in progress, so the control side can
+// wait for them after clearing trace_on.
+typedef struct {
+    atomic_uint head;
+    atomic_uint writers;
+    trace_event_t ev[TRACE_EVENTS];
+} trace_ring_t;
+
+static trace_ring_t rings[TRACE_CORES];
+static atomic_bool trace_on;
+
+static TaskStatus_t task_status[TRACE_MAX_TASKS];
+static char task_names[TRACE_MAX_TASKS][configMAX_TASK_NAME_LEN];
+static int task_count;
+
+static const char *const span_names[TRACE_STAGE] = {
+    [TRACE_I2S_READ]  = "I2S read",
+    [TRACE_I2S_WRITE] = "I2S write",
+    [TRACE_PIPELINE]  = "pipeline",
+    [TRACE_FFT]       = "FFT",
+    [TRACE_METER]     = "meters",
+    [TRACE_VAD]       = "VAD",
+    [TRACE_CAPTURE]   = "capture",
+    [TRACE_UART_TX]   = "UART TX",
+    [TRACE_TELEMETRY] = "telemetry",
+    [TRACE_PITCH]     = "pitch",
+};
+
+static IRAM_ATTR void trace_put(uint8_t type, uint8_t id, uint16_t arg)
+{
+    trace_ring_t *r = &rings[xPortGetCoreID()];
+
+    // announce, then re-check: pairs with trace_quiesce()
+    atomic_fetch_add(&r->writers, 1);
+    if (atomic_load(&trace_on)) {
+        unsigned i = atomic_fetch_add_explicit(&r->head, 1, memory_order_relaxed);
+        trace_event_t *e = &r->ev[i & (TRACE_EVENTS - 1)];
+        e->ts = (uint32_t)esp_timer_get_time();
+        e->type = type;
+        e->id = id;
+        e->arg = arg;
+    }
+    atomic_fetch_sub_explicit(&r->writers, 1, memory_order_release);
+}
+
+static inline uint8_t current_task(void)
+{
+    return (uint8_t)uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle());
+}
+
+IRAM_ATTR void trace_event(uint8_t type, uint8_t id)
+{
+    if (!atomic_load_explicit(&trace_on, memory_order_relaxed)) return;
+    trace_put(type, id, current_task());
+}
+
+IRAM_ATTR void trace_task_switched_in(void)
+{
+    if (!atomic_load_explicit(&trace_on, memory_order_relaxed)) return;
+    trace_put(TRACE_EV_SWITCH_IN, current_task(), 0);
+}
+
+IRAM_ATTR void trace_task_switched_out(void)
+{
+    if (!atomic_load_explicit(&trace_on, memory_order_relaxed)) return;
+    trace_put(TRACE_EV_SWITCH_OUT, current_task(), 0);
+}
+
+// Task numbers 1..n for the events, 0 for tasks created after TRACE ON
+static void trace_number_tasks(void)
+{
+    task_count = 0;
+    if (uxTaskGetNumberOfTasks() > TRACE_MAX_TASKS) return;
+
+    UBaseType_t n = uxTaskGetSystemState(task_status, TRACE_MAX_TASKS, NULL);
+    for (UBaseType_t i = 0; i < n; i++) {
+        vTaskSetTaskNumber(task_status[i].xHandle, i + 1);
+        snprintf(task_names[i], sizeof(task_names[i]), "%s", task_status[i].pcTaskName);
+    }
+    task_count = (int)n;
+}
+
+// Stops recording and waits until no trace_put() is still writing a slot:
+// any writer that missed the cleared flag has already announced itself
+static void trace_quiesce(void)
+{
+    atomic_store(&trace_on, false);
+    for (int c = 0; c < TRACE_CORES; c++)
+        while (atomic_load(&rings[c].writers) != 0)
+            vTaskDelay(1);
+}
+
+void trace_start(void)
+{
+    trace_quiesce();
+    trace_number_tasks();
+    for (int c = 0; c < TRACE_CORES; c++)
+        atomic_store(&rings[c].head, 0u);
+    atomic_store(&trace_on, true);
+}
+
+void trace_stop(void)
+{
+    atomic_store(&trace_on, false);
+}
+
+bool trace_running(void)
+{
+    return atomic_load(&trace_on);
+}
+
+uint32_t trace_count(int core)
+{
+    return atomic_load(&rings[core].head);
+}
+
+static void put_u16(uint8_t *p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+static void put_u32(uint8_t *p, uint32_t v) { p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24; }
+
+static void send_name(uint8_t kind, uint8_t id, const char *name)
+{
+    uint8_t frame[2 + 32];
+    size_t len = strnlen(name, 32);
+    frame[0] = kind;
+    frame[1] = id;
+    memcpy(&frame[2], name, len);
+    uart_write_frame(FRAME_TRACE_NAME, frame, (uint16_t)(2 + len));
+}
+
+void trace_dump(int baud)
+{
+    static uint8_t frame[2 + TRACE_CHUNK * sizeof(trace_event_t)];
+
+    trace_quiesce();
+
+    uart_tx_lock();
+    if (baud > 0) {
+        char msg[48];
+        int n = snprintf(msg, sizeof(msg), "TRACE:BAUD=%d\r\n", baud);
+        uart_write_raw(msg, n);
+        uart_set_link_baud(baud);
+        vTaskDelay(pdMS_TO_TICKS(100));     // let the host follow
+    }
+
+    frame[0] = 1;                           // format version
+    frame[1] = TRACE_CORES;
+    put_u32(&frame[2], TRACE_EVENTS);
+    uart_write_frame(FRAME_TRACE_HEADER, frame, 6);
+
+    for (int i = 0; i < task_count; i++)
+        send_name(0, (uint8_t)(i + 1), task_names[i]);
+    for (int i = 0; i < TRACE_STAGE; i++)
+        if (span_names[i]) send_name(1, (uint8_t)i, span_names[i]);
+    for (int i = 0; i < STAGE_COUNT; i++)
+        send_name(1, (uint8_t)(TRACE_STAGE + i), stage_name((stage_id_t)i));
+    send_name(1, TRACE_STAGE + STAGE_COUNT, "pipeline variant");
+
+    // oldest to newest, ring by ring
+    for (int c = 0; c < TRACE_CORES; c++) {
+        uint32_t head = trace_count(c);
+        uint32_t n = (head < TRACE_EVENTS) ? head : TRACE_EVENTS;
+        for (uint32_t i = head - n; i < head; ) {
+            int k = 0;
+            uint8_t *p = &frame[2];
+            for (; k < TRACE_CHUNK && i < head; k++, i++) {
+                const trace_event_t *e = &rings[c].ev[i & (TRACE_EVENTS - 1)];
+                put_u32(p, e->ts);
+                p[4] = e->type;
+                p[5] = e->id;
+                put_u16(&p[6], e->arg);
+                p += sizeof(trace_event_t);
+            }
+            frame[0] = (uint8_t)c;
+            frame[1] = (uint8_t)k;
+            uart_write_frame(FRAME_TRACE_EVENTS, frame, (uint16_t)(p - frame));
+        }
+    }
+
+    // events recorded per core, anything above TRACE_EVENTS was overwritten
+    for (int c = 0; c < TRACE_CORES; c++)
+        put_u32(&frame[4 * c], trace_count(c));
+    uart_write_frame(FRAME_TRACE_END, frame, 4 * TRACE_CORES);
+
+    if (baud > 0) uart_set_link_baud(0);
+    uart_tx_unlock();
+}
+#endif
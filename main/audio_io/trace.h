@@ -0,0 +1,60 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+// Event tracing (CONFIG_AUDIO_TRACE): one lock-free ring per core, written
+// by the FreeRTOS task switch hooks (trace_hooks.h) and by the TRACE_BEGIN /
+// TRACE_END markers. Without the option the markers are empty.
+
+// Event types
+#define TRACE_EV_SWITCH_IN   1      // id: task number
+#define TRACE_EV_SWITCH_OUT  2
+#define TRACE_EV_BEGIN       3      // id: trace_span_t, arg: task number
+#define TRACE_EV_END         4
+
+// Marker ids; pipeline stages follow TRACE_STAGE, one per stage_id_t, then
+// one for the precompiled variants
+typedef enum {
+    TRACE_I2S_READ = 0,
+    TRACE_I2S_WRITE,
+    TRACE_PIPELINE,
+    TRACE_FFT,
+    TRACE_METER,
+    TRACE_VAD,
+    TRACE_CAPTURE,
+    TRACE_UART_TX,
+    TRACE_TELEMETRY,
+    TRACE_PITCH,
+    TRACE_STAGE = 16,
+} trace_span_t;
+
+typedef struct {
+    uint32_t ts;            // esp_timer µs, low 32 bits
+    uint8_t  type;          // TRACE_EV_*
+    uint8_t  id;
+    uint16_t arg;
+} trace_event_t;
+
+#if CONFIG_AUDIO_TRACE
+
+void trace_event(uint8_t type, uint8_t id);
+
+#define TRACE_BEGIN(id)  trace_event(TRACE_EV_BEGIN, (uint8_t)(id))
+#define TRACE_END(id)    trace_event(TRACE_EV_END, (uint8_t)(id))
+
+// Control side (UART task)
+void trace_start(void);                 // clears the rings, numbers the tasks
+void trace_stop(void);
+bool trace_running(void);
+uint32_t trace_count(int core);         // events recorded since start
+void trace_dump(int baud);              // stops, then sends the rings as frames
+
+#else
+
+#define TRACE_BEGIN(id)  ((void)0)
+#define TRACE_END(id)    ((void)0)
+
+#endif
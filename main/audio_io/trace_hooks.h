@@ -0,0 +1,14 @@
+#pragma once
+
+// Force-included into the FreeRTOS kernel build when CONFIG_AUDIO_TRACE is
+// set (main/CMakeLists.txt), ahead of FreeRTOS.h which only supplies the
+// trace macros nobody defined. Must not include any FreeRTOS header.
+#include "sdkconfig.h"
+
+#if CONFIG_AUDIO_TRACE
+void trace_task_switched_in(void);
+void trace_task_switched_out(void);
+
+#define traceTASK_SWITCHED_IN()    trace_task_switched_in()
+#define traceTASK_SWITCHED_OUT()   trace_task_switched_out()
+#endif
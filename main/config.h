@@ -1,11 +1,13 @@
 #pragma once
+#include "sdkconfig.h"
 #include "driver/gpio.h"
 #include "driver/i2s_std.h"
 
 #define TAG "I2S_LOOPBACK_IIR"
 
 // === Audio Parameters ===
-#define I2S_SR             48000 // sampling frequency
+#define I2S_SR_DEFAULT     48000 // boot sampling frequency, switchable at runtime (RATE)
+#define I2S_BLOCK          CONFIG_AUDIO_BLOCK_SIZE  // samples per DMA frame / DSP block
 
 // === Control Button ===
 #define SWITCH_GPIO        GPIO_NUM_0
@@ -0,0 +1,48 @@
+#include "name_index.h"
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+// FNV-1a over upper-cased characters
+static uint32_t name_hash(const char *s)
+{
+    uint32_t h = 2166136261u;
+    while (*s) {
+        h ^= (uint8_t)toupper((unsigned char)*s++);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void name_index_clear(name_index_t *ix)
+{
+    memset(ix, 0, sizeof(*ix));
+}
+
+bool name_index_add(name_index_t *ix, const char *key, uint16_t value)
+{
+    if (ix->count >= NAME_INDEX_SLOTS / 2) return false;
+
+    uint32_t i = name_hash(key) & (NAME_INDEX_SLOTS - 1);
+    while (ix->key[i]) {
+        if (strcasecmp(ix->key[i], key) == 0) return false;     // duplicate
+        i = (i + 1) & (NAME_INDEX_SLOTS - 1);
+    }
+    ix->key[i] = key;
+    ix->value[i] = value;
+    ix->count++;
+    return true;
+}
+
+bool name_index_find(const name_index_t *ix, const char *key, uint16_t *value)
+{
+    uint32_t i = name_hash(key) & (NAME_INDEX_SLOTS - 1);
+    while (ix->key[i]) {
+        if (strcasecmp(ix->key[i], key) == 0) {
+            *value = ix->value[i];
+            return true;
+        }
+        i = (i + 1) & (NAME_INDEX_SLOTS - 1);
+    }
+    return false;
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#define NAME_INDEX_SLOTS  128   // power of two, keep load below ~50 %
+
+// Case-insensitive open-addressing hash of static names → small ids.
+// Built once at init, lookups cost one hash and (almost always) one compare.
+typedef struct {
+    const char *key[NAME_INDEX_SLOTS];
+    uint16_t value[NAME_INDEX_SLOTS];
+    int count;
+} name_index_t;
+
+void name_index_clear(name_index_t *ix);
+bool name_index_add(name_index_t *ix, const char *key, uint16_t value);
+bool name_index_find(const name_index_t *ix, const char *key, uint16_t *value);
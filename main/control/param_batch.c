@@ -0,0 +1,46 @@
+#include "param_batch.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "rtos_wait.h"
+
+void param_mailbox_init(param_mailbox_t *mb)
+{
+    memset(mb, 0, sizeof(*mb));
+    atomic_init(&mb->pending, NULL);
+    atomic_init(&mb->applied_id, 0u);
+}
+
+static bool applied(param_mailbox_t *mb, uint32_t id)
+{
+    return atomic_load_explicit(&mb->applied_id, memory_order_acquire) == id;
+}
+
+bool param_mailbox_post_wait(param_mailbox_t *mb, int timeout_ms)
+{
+    uint32_t id = ++mb->next_id;
+    mb->batch.id = id;
+    atomic_store_explicit(&mb->pending, &mb->batch, memory_order_release);
+
+    // the audio task takes it at the next block boundary; poll per tick
+    deadline_t d = deadline_after_ms(timeout_ms);
+    while (!applied(mb, id)) {
+        if (deadline_passed(&d)) {
+            // audio task stalled: withdraw the batch unless it was just claimed
+            param_batch_t *expected = &mb->batch;
+            if (atomic_compare_exchange_strong(&mb->pending, &expected, NULL))
+                return false;
+            while (!applied(mb, id))
+                vTaskDelay(1);      // claimed: applied within the block
+            return true;
+        }
+        vTaskDelay(1);
+    }
+    return true;
+}
+
+void param_batch_apply(const param_batch_t *b)
+{
+    for (int i = 0; i < b->count; i++)
+        param_apply(b->ops[i].id, b->ops[i].value);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#include "param_registry.h"
+
+#define PARAM_BATCH_MAX  24     // parameters per SET line
+
+typedef struct {
+    uint32_t id;            // assigned by param_mailbox_post_wait()
+    int count;
+    param_op_t ops[PARAM_BATCH_MAX];
+} param_batch_t;
+
+// Control side fills `batch`, posts it and waits; the audio task applies
+// every op of a batch at one block boundary.
+typedef struct {
+    param_batch_t batch;
+    _Atomic(param_batch_t *) pending;
+    atomic_uint applied_id;
+    uint32_t next_id;
+} param_mailbox_t;
+
+void param_mailbox_init(param_mailbox_t *mb);
+
+// Control side: fill mb->batch, then post it; true once the audio task
+// applied it, false if it was withdrawn after timeout_ms
+bool param_mailbox_post_wait(param_mailbox_t *mb, int timeout_ms);
+
+// Audio task, once per block before processing
+void param_batch_apply(const param_batch_t *b);
+
+static inline void param_mailbox_apply(param_mailbox_t *mb)
+{
+    if (!atomic_load_explicit(&mb->pending, memory_order_relaxed)) return;
+
+    // claim it, the control side may have withdrawn it meanwhile
+    param_batch_t *b = atomic_exchange_explicit(&mb->pending, NULL, memory_order_acquire);
+    if (!b) return;
+    param_batch_apply(b);
+    atomic_store_explicit(&mb->applied_id, b->id, memory_order_release);
+}
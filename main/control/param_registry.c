@@ -0,0 +1,272 @@
+#include "param_registry.h"
+#include <stdlib.h>
+#include <strings.h>
+#include <math.h>
+
+#include "iir_filter.h"
+#include "name_index.h"
+
+static struct {
+    float fs;
+    expander_t *exp;
+    compressor_t *comp;
+    limiter_t *lim;
+    dyn_eq_t *dyn;
+    name_index_t index;
+    float value[PARAM_COUNT];
+} reg;
+
+// ---------------- derived values ----------------
+
+static float ms_to_coeff(float ms)
+{
+    return expf(-1.0f / (reg.fs * fmaxf(ms, 0.01f) * 0.001f));
+}
+
+static float db_to_lin(float db)
+{
+    return powf(10.0f, db / 20.0f);
+}
+
+// ---------------- updaters ----------------
+
+static void update_eq(param_id_t id, float v)
+{
+    int k = id - P_EQ_LOW_FC;
+    eq_band_t *b = (eq_band_t *)eq_get_band((eq_band_id_t)(k / 3));
+    switch (k % 3) {
+        case 0: b->fc      = v; break;
+        case 1: b->Q       = v; break;
+        case 2: b->gain_db = v; break;
+    }
+    update_filter_coefficients_eq(b);
+}
+
+static void update_expander(param_id_t id, float v)
+{
+    expander_t *e = reg.exp;
+    switch (id) {
+        case P_EXP_THRESHOLD: e->threshold     = v; break;
+        case P_EXP_RATIO:     e->ratio         = v; break;
+        case P_EXP_ATTACK:    e->attack_coeff  = ms_to_coeff(v); break;
+        case P_EXP_RELEASE:   e->release_coeff = ms_to_coeff(v); break;
+        case P_EXP_HOLD:      e->hold_time     = v * 0.001f; break;
+        case P_EXP_KEY:       e->key_open = true; e->key_enabled = (v != 0.0f); break;
+        case P_EXP_KEY_FLOOR: e->key_floor     = db_to_lin(v); break;
+        default: break;
+    }
+}
+
+static void update_compressor(param_id_t id, float v)
+{
+    compressor_t *c = reg.comp;
+    switch (id) {
+        case P_COMP_THRESHOLD: c->threshold     = v; break;
+        case P_COMP_RATIO:     c->ratio         = v; break;
+        case P_COMP_MAKEUP:    c->makeup        = db_to_lin(v); break;
+        case P_COMP_ATTACK:    c->attack_coeff  = ms_to_coeff(v); break;
+        case P_COMP_RELEASE:   c->release_coeff = ms_to_coeff(v); break;
+        case P_COMP_KNEE:      c->knee_db       = v; break;
+        default: break;
+    }
+}
+
+static void update_limiter(param_id_t id, float v)
+{
+    limiter_t *l = reg.lim;
+    switch (id) {
+        case P_LIMIT_THRESHOLD: l->threshold = v; break;
+        case P_LIMIT_ATTACK:    l->attack = v * 0.001f; l->att_coeff = ms_to_coeff(v); break;
+        case P_LIMIT_RELEASE:   l->release = v * 0.001f; l->rel_coeff = ms_to_coeff(v); break;
+        default: break;
+    }
+}
+
+static void update_dyn_eq(param_id_t id, float v)
+{
+    dyn_eq_t *d = reg.dyn;
+    if (id >= P_DYN1_ON && id <= P_DYN2_RANGE) {
+        int k = (id - P_DYN1_ON) / 6;
+        dyn_eq_band_t *b = &d->band[k];
+        switch ((id - P_DYN1_ON) % 6) {
+            case 0: b->enabled      = (v != 0.0f); break;
+            case 1: b->fc           = v; break;
+            case 2: b->Q            = v; break;
+            case 3: b->threshold_db = v; break;
+            case 4: b->ratio        = v; break;
+            case 5: b->range_db     = v; break;
+        }
+    }
+    else if (id == P_DYN_ATTACK)  d->attack_ms  = v;
+    else if (id == P_DYN_RELEASE) d->release_ms = v;
+    dyn_eq_update(d);
+}
+
+// ---------------- table ----------------
+
+#define PF(n, g, u, lo, hi, d, fn)  { n, g, u, PARAM_T_FLOAT, lo, hi, d, fn }
+#define PB(n, g, d, fn)             { n, g, "",  PARAM_T_BOOL, 0, 1, d, fn }
+
+static const param_def_t defs[PARAM_COUNT] = {
+    [P_EQ_LOW_FC]       = PF("EQ_LOW_FC",          "EQ",       "Hz",  20.0f, 20000.0f, 100.0f,  update_eq),
+    [P_EQ_LOW_Q]        = PF("EQ_LOW_Q",           "EQ",       "",    0.3f,  10.0f,    0.707f,  update_eq),
+    [P_EQ_LOW_GAIN]     = PF("EQ_LOW_GAIN",        "EQ",       "dB",  -8.0f, 8.0f,     0.0f,    update_eq),
+    [P_EQ_MID_FC]       = PF("EQ_MID_FC",          "EQ",       "Hz",  20.0f, 20000.0f, 1200.0f, update_eq),
+    [P_EQ_MID_Q]        = PF("EQ_MID_Q",           "EQ",       "",    0.3f,  10.0f,    1.0f,    update_eq),
+    [P_EQ_MID_GAIN]     = PF("EQ_MID_GAIN",        "EQ",       "dB",  -8.0f, 8.0f,     0.0f,    update_eq),
+    [P_EQ_HIGH_FC]      = PF("EQ_HIGH_FC",         "EQ",       "Hz",  20.0f, 20000.0f, 8000.0f, update_eq),
+    [P_EQ_HIGH_Q]       = PF("EQ_HIGH_Q",          "EQ",       "",    0.3f,  10.0f,    0.707f,  update_eq),
+    [P_EQ_HIGH_GAIN]    = PF("EQ_HIGH_GAIN",       "EQ",       "dB",  -8.0f, 8.0f,     0.0f,    update_eq),
+
+    [P_EXP_THRESHOLD]   = PF("EXPANDER_THRESHOLD", "EXPANDER", "lin", 0.0f,  1.0f,     0.02f,   update_expander),
+    [P_EXP_RATIO]       = PF("EXPANDER_RATIO",     "EXPANDER", ":1",  1.0f,  10.0f,    2.0f,    update_expander),
+    [P_EXP_ATTACK]      = PF("EXPANDER_ATTACK",    "EXPANDER", "ms",  0.1f,  100.0f,   5.0f,    update_expander),
+    [P_EXP_RELEASE]     = PF("EXPANDER_RELEASE",   "EXPANDER", "ms",  1.0f,  1000.0f,  100.0f,  update_expander),
+    [P_EXP_HOLD]        = PF("EXPANDER_HOLD",      "EXPANDER", "ms",  0.0f,  1000.0f,  100.0f,  update_expander),
+    [P_EXP_KEY]         = PB("EXPANDER_KEY",       "EXPANDER", 0.0f,                            update_expander),
+    [P_EXP_KEY_FLOOR]   = PF("EXPANDER_KEY_FLOOR", "EXPANDER", "dB",  -60.0f, 0.0f,    -20.0f,  update_expander),
+
+    [P_COMP_THRESHOLD]  = PF("COMP_THRESHOLD",     "COMP",     "lin", 0.0f,  1.0f,     0.3f,    update_compressor),
+    [P_COMP_RATIO]      = PF("COMP_RATIO",         "COMP",     ":1",  1.0f,  20.0f,    4.0f,    update_compressor),
+    [P_COMP_MAKEUP]     = PF("COMP_MAKEUP",        "COMP",     "dB",  0.0f,  24.0f,    4.0f,    update_compressor),
+    [P_COMP_ATTACK]     = PF("COMP_ATTACK",        "COMP",     "ms",  0.1f,  100.0f,   10.0f,   update_compressor),
+    [P_COMP_RELEASE]    = PF("COMP_RELEASE",       "COMP",     "ms",  1.0f,  1000.0f,  120.0f,  update_compressor),
+    [P_COMP_KNEE]       = PF("COMP_KNEE",          "COMP",     "dB",  0.0f,  24.0f,    6.0f,    update_compressor),
+
+    [P_LIMIT_THRESHOLD] = PF("LIMIT_THRESHOLD",    "LIMIT",    "lin", 0.05f, 1.0f,     0.6f,    update_limiter),
+    [P_LIMIT_ATTACK]    = PF("LIMIT_ATTACK",       "LIMIT",    "ms",  0.1f,  50.0f,    3.0f,    update_limiter),
+    [P_LIMIT_RELEASE]   = PF("LIMIT_RELEASE",      "LIMIT",    "ms",  1.0f,  1000.0f,  150.0f,  update_limiter),
+
+    [P_DYN1_ON]         = PB("DYN1_ON",            "DYNEQ",    0.0f,                            update_dyn_eq),
+    [P_DYN1_FC]         = PF("DYN1_FC",            "DYNEQ",    "Hz",  200.0f, 16000.0f, DYN_EQ_DEESS_FC, update_dyn_eq),
+    [P_DYN1_Q]          = PF("DYN1_Q",             "DYNEQ",    "",    0.5f,  8.0f,     DYN_EQ_DEESS_Q,  update_dyn_eq),
+    [P_DYN1_THRESHOLD]  = PF("DYN1_THRESHOLD",     "DYNEQ",    "dB",  -60.0f, 0.0f,    -30.0f,  update_dyn_eq),
+    [P_DYN1_RATIO]      = PF("DYN1_RATIO",         "DYNEQ",    ":1",  1.0f,  20.0f,    4.0f,    update_dyn_eq),
+    [P_DYN1_RANGE]      = PF("DYN1_RANGE",         "DYNEQ",    "dB",  0.0f,  24.0f,    10.0f,   update_dyn_eq),
+    [P_DYN2_ON]         = PB("DYN2_ON",            "DYNEQ",    0.0f,                            update_dyn_eq),
+    [P_DYN2_FC]         = PF("DYN2_FC",            "DYNEQ",    "Hz",  200.0f, 16000.0f, 3000.0f, update_dyn_eq),
+    [P_DYN2_Q]          = PF("DYN2_Q",             "DYNEQ",    "",    0.5f,  8.0f,     1.4f,    update_dyn_eq),
+    [P_DYN2_THRESHOLD]  = PF("DYN2_THRESHOLD",     "DYNEQ",    "dB",  -60.0f, 0.0f,    -24.0f,  update_dyn_eq),
+    [P_DYN2_RATIO]      = PF("DYN2_RATIO",         "DYNEQ",    ":1",  1.0f,  20.0f,    3.0f,    update_dyn_eq),
+    [P_DYN2_RANGE]      = PF("DYN2_RANGE",         "DYNEQ",    "dB",  0.0f,  24.0f,    6.0f,    update_dyn_eq),
+    [P_DYN_ATTACK]      = PF("DYN_ATTACK",         "DYNEQ",    "ms",  0.1f,  50.0f,    1.0f,    update_dyn_eq),
+    [P_DYN_RELEASE]     = PF("DYN_RELEASE",        "DYNEQ",    "ms",  5.0f,  1000.0f,  60.0f,   update_dyn_eq),
+};
+
+// ---------------- presets ----------------
+
+static const param_op_t preset_deess[] = {
+    { P_DYN1_ON, 1.0f },
+    { P_DYN1_FC, DYN_EQ_DEESS_FC },     // 5-9 kHz
+    { P_DYN1_Q, DYN_EQ_DEESS_Q },
+    { P_DYN1_THRESHOLD, -30.0f },
+    { P_DYN1_RATIO, 4.0f },
+    { P_DYN1_RANGE, 10.0f },
+    { P_DYN_ATTACK, 1.0f },
+    { P_DYN_RELEASE, 60.0f },
+};
+
+static const struct {
+    const char *name;
+    const param_op_t *ops;
+    int count;
+} presets[] = {
+    { "DEESS", preset_deess, sizeof(preset_deess) / sizeof(preset_deess[0]) },
+};
+
+// ---------------- API ----------------
+
+void param_registry_init(float fs, expander_t *e, compressor_t *c, limiter_t *l, dyn_eq_t *d)
+{
+    reg.fs = fs;
+    reg.exp = e;
+    reg.comp = c;
+    reg.lim = l;
+    reg.dyn = d;
+
+    name_index_clear(&reg.index);
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        name_index_add(&reg.index, defs[i].name, (uint16_t)i);
+        reg.value[i] = defs[i].def;
+        param_apply((param_id_t)i, defs[i].def);
+    }
+}
+
+void param_registry_set_sample_rate(float fs)
+{
+    reg.fs = fs;
+    reg.exp->fs = fs;
+    reg.comp->fs = fs;
+    reg.lim->fs = fs;
+    reg.dyn->fs = fs;
+    for (int i = 0; i < PARAM_COUNT; i++)
+        param_apply((param_id_t)i, reg.value[i]);
+}
+
+const param_def_t *param_def(param_id_t id)
+{
+    return (id < PARAM_COUNT) ? &defs[id] : NULL;
+}
+
+const char *param_type_to_str(param_type_t t)
+{
+    switch (t) {
+        case PARAM_T_FLOAT: return "f";
+        case PARAM_T_INT:   return "i";
+        case PARAM_T_BOOL:  return "b";
+        default:            return "?";
+    }
+}
+
+bool param_lookup(const char *name, param_id_t *id)
+{
+    if (name[0] == '#') {
+        char *end;
+        long n = strtol(name + 1, &end, 10);
+        if (end == name + 1 || *end || n < 0 || n >= PARAM_COUNT) return false;
+        *id = (param_id_t)n;
+        return true;
+    }
+
+    uint16_t v;
+    if (!name_index_find(&reg.index, name, &v)) return false;
+    *id = (param_id_t)v;
+    return true;
+}
+
+bool param_validate(param_id_t id, float *v)
+{
+    const param_def_t *d = param_def(id);
+    if (!d || isnan(*v)) return false;
+
+    if (d->type == PARAM_T_BOOL) *v = (*v != 0.0f) ? 1.0f : 0.0f;
+    else if (d->type == PARAM_T_INT) *v = roundf(*v);
+
+    return *v >= d->min && *v <= d->max;
+}
+
+const param_op_t *param_preset(const char *name, int *count)
+{
+    for (size_t i = 0; i < sizeof(presets) / sizeof(presets[0]); i++) {
+        if (strcasecmp(presets[i].name, name) == 0) {
+            *count = presets[i].count;
+            return presets[i].ops;
+        }
+    }
+    return NULL;
+}
+
+float param_get(param_id_t id)
+{
+    return (id < PARAM_COUNT) ? reg.value[id] : NAN;
+}
+
+void param_store(param_id_t id, float v)
+{
+    if (id < PARAM_COUNT) reg.value[id] = v;
+}
+
+void param_apply(param_id_t id, float v)
+{
+    if (id < PARAM_COUNT) defs[id].update(id, v);
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "expander.h"
+#include "compressor.h"
+#include "limiter.h"
+#include "dyn_eq.h"
+
+typedef enum {
+    PARAM_T_FLOAT = 0,
+    PARAM_T_INT,
+    PARAM_T_BOOL
+} param_type_t;
+
+// Numeric ids are part of the wire protocol (#<id>): append only
+typedef enum {
+    P_EQ_LOW_FC = 0, P_EQ_LOW_Q, P_EQ_LOW_GAIN,
+    P_EQ_MID_FC, P_EQ_MID_Q, P_EQ_MID_GAIN,
+    P_EQ_HIGH_FC, P_EQ_HIGH_Q, P_EQ_HIGH_GAIN,
+    P_EXP_THRESHOLD, P_EXP_RATIO, P_EXP_ATTACK, P_EXP_RELEASE, P_EXP_HOLD,
+    P_EXP_KEY, P_EXP_KEY_FLOOR,
+    P_COMP_THRESHOLD, P_COMP_RATIO, P_COMP_MAKEUP, P_COMP_ATTACK, P_COMP_RELEASE,
+    P_COMP_KNEE,
+    P_LIMIT_THRESHOLD, P_LIMIT_ATTACK, P_LIMIT_RELEASE,
+    P_DYN1_ON, P_DYN1_FC, P_DYN1_Q, P_DYN1_THRESHOLD, P_DYN1_RATIO, P_DYN1_RANGE,
+    P_DYN2_ON, P_DYN2_FC, P_DYN2_Q, P_DYN2_THRESHOLD, P_DYN2_RATIO, P_DYN2_RANGE,
+    P_DYN_ATTACK, P_DYN_RELEASE,
+    PARAM_COUNT
+} param_id_t;
+
+typedef struct {
+    const char *name;       // UART key, e.g. "COMP_ATTACK"
+    const char *group;      // GUI tab
+    const char *unit;
+    param_type_t type;
+    float min, max, def;
+    void (*update)(param_id_t id, float v);    // derive + write module state (audio task)
+} param_def_t;
+
+// Applies every default to the modules; call before the audio task starts
+void param_registry_init(float fs, expander_t *e, compressor_t *c, limiter_t *l, dyn_eq_t *d);
+
+// Audio task: re-derives every time-based coefficient from the stored values
+void param_registry_set_sample_rate(float fs);
+
+const param_def_t *param_def(param_id_t id);
+const char *param_type_to_str(param_type_t t);
+
+// "COMP_RATIO" or "#17"
+bool param_lookup(const char *name, param_id_t *id);
+
+// Coerces to the parameter type, false when out of range
+bool param_validate(param_id_t id, float *v);
+
+typedef struct {
+    param_id_t id;
+    float value;            // validated, user units
+} param_op_t;
+
+// Named set of values ("DEESS"), NULL if unknown
+const param_op_t *param_preset(const char *name, int *count);
+
+// Control-side value (user units) of the last applied setting
+float param_get(param_id_t id);
+void  param_store(param_id_t id, float v);
+
+// Audio task: converts and writes into the DSP module
+void param_apply(param_id_t id, float v);
@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Short waits on the audio task. pdMS_TO_TICKS() rounds down: at the
+// target's default 100 Hz tick anything under 10 ms is 0 ticks, and
+// vTaskDelay(0) only yields. Waits are measured against the tick count
+// instead, and every sleep is at least one tick.
+
+// ms rounded up to whole ticks, at least 1
+static inline TickType_t ms_to_ticks_ceil(uint32_t ms)
+{
+    TickType_t t = (TickType_t)(((uint64_t)ms * configTICK_RATE_HZ + 999) / 1000);
+    return t ? t : 1;
+}
+
+typedef struct {
+    TickType_t start;
+    TickType_t ticks;
+} deadline_t;
+
+// Expires no earlier than `ms` from now: one extra tick covers the part of
+// the current tick already gone
+static inline deadline_t deadline_after_ms(uint32_t ms)
+{
+    deadline_t d = { xTaskGetTickCount(), ms_to_ticks_ceil(ms) + 1 };
+    return d;
+}
+
+static inline bool deadline_passed(const deadline_t *d)
+{
+    return (TickType_t)(xTaskGetTickCount() - d->start) >= d->ticks;
+}
@@ -0,0 +1,78 @@
+#include "subscription.h"
+#include <stdatomic.h>
+#include <strings.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *const names[SUB_COUNT] = { "METERS", "SPECTRUM", "GR", "STATS", "PITCH" };
+
+static atomic_uint rate_hz[SUB_COUNT];
+static atomic_uint last_seen;           // tick of the last host line
+static atomic_bool lapsed;              // set once per silence, cleared by the host
+
+void sub_init(void)
+{
+    for (int i = 0; i < SUB_COUNT; i++)
+        atomic_init(&rate_hz[i], 0u);
+    atomic_init(&last_seen, (unsigned)xTaskGetTickCount());
+    atomic_init(&lapsed, false);
+}
+
+const char *sub_name(sub_stream_t s)
+{
+    return (s < SUB_COUNT) ? names[s] : "?";
+}
+
+bool sub_from_name(const char *name, sub_stream_t *s)
+{
+    for (int i = 0; i < SUB_COUNT; i++) {
+        if (strcasecmp(name, names[i]) == 0) {
+            *s = (sub_stream_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool sub_set(sub_stream_t s, unsigned hz)
+{
+    if (s >= SUB_COUNT || hz > SUB_HZ_MAX) return false;
+    atomic_store_explicit(&rate_hz[s], hz, memory_order_relaxed);
+    return true;
+}
+
+void sub_clear(void)
+{
+    for (int i = 0; i < SUB_COUNT; i++)
+        atomic_store_explicit(&rate_hz[i], 0u, memory_order_relaxed);
+}
+
+unsigned sub_rate(sub_stream_t s)
+{
+    return atomic_load_explicit(&rate_hz[s], memory_order_relaxed);
+}
+
+bool sub_any(void)
+{
+    for (int i = 0; i < SUB_COUNT; i++)
+        if (sub_rate((sub_stream_t)i)) return true;
+    return false;
+}
+
+void sub_keepalive(void)
+{
+    atomic_store_explicit(&last_seen, (unsigned)xTaskGetTickCount(), memory_order_relaxed);
+    atomic_store_explicit(&lapsed, false, memory_order_relaxed);
+}
+
+bool sub_expire(void)
+{
+    if (atomic_load_explicit(&lapsed, memory_order_relaxed)) return false;
+
+    unsigned idle = (unsigned)xTaskGetTickCount()
+                  - atomic_load_explicit(&last_seen, memory_order_relaxed);
+    if (idle < pdMS_TO_TICKS(SUB_TTL_MS)) return false;
+    atomic_store_explicit(&lapsed, true, memory_order_relaxed);
+    sub_clear();
+    return true;
+}
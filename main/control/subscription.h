@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Telemetry streams the host subscribes to with a rate. A stream is only
+// computed and sent while it has a subscriber; every subscription lapses
+// after SUB_TTL_MS without a command line from the host.
+typedef enum {
+    SUB_METERS,         // METERS: window meters, one window per period
+    SUB_SPECTRUM,       // STREAM: RMS, VAD probability, FFT bands
+    SUB_GR,             // GR: instantaneous gain reduction per stage
+    SUB_STATS,          // STATS: block timing and TX queue
+    SUB_PITCH,          // PITCH: F0 tracker, computed only while subscribed
+    SUB_COUNT
+} sub_stream_t;
+
+#define SUB_TTL_MS      5000
+#define SUB_HZ_MAX      50
+
+void sub_init(void);
+const char *sub_name(sub_stream_t s);
+bool sub_from_name(const char *name, sub_stream_t *s);
+
+// Any task; 0 Hz unsubscribes, false above SUB_HZ_MAX
+bool sub_set(sub_stream_t s, unsigned hz);
+void sub_clear(void);
+unsigned sub_rate(sub_stream_t s);
+bool sub_any(void);
+
+// UART task, on every received line
+void sub_keepalive(void);
+
+// Telemetry task: drops every subscription once the host went quiet for
+// SUB_TTL_MS, true once per silence so other host streams can stop too
+bool sub_expire(void);
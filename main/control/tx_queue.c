@@ -0,0 +1,121 @@
+#include "tx_queue.h"
+#include <string.h>
+
+static void ring_init(txq_ring_t *r)
+{
+    for (unsigned i = 0; i < TXQ_DEPTH; i++)
+        atomic_init(&r->cells[i].seq, i);
+    atomic_init(&r->enq, 0u);
+    atomic_init(&r->deq, 0u);
+    atomic_init(&r->drops, 0u);
+    atomic_init(&r->high_water, 0u);
+}
+
+void tx_queue_init(tx_queue_t *q)
+{
+    for (int p = 0; p < TXQ_PRIO_COUNT; p++)
+        ring_init(&q->ring[p]);
+}
+
+static bool ring_push(txq_ring_t *r, const char *msg, size_t len)
+{
+    unsigned pos = atomic_load_explicit(&r->enq, memory_order_relaxed);
+    txq_cell_t *cell;
+
+    // claim a slot: its seq equals pos when free for this lap
+    for (;;) {
+        cell = &r->cells[pos & (TXQ_DEPTH - 1)];
+        unsigned seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        int diff = (int)(seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&r->enq, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0) {
+            return false;                                       // full
+        }
+        else {
+            pos = atomic_load_explicit(&r->enq, memory_order_relaxed);
+        }
+    }
+
+    memcpy(cell->data, msg, len);
+    cell->len = (uint16_t)len;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+
+    unsigned depth = pos + 1 - atomic_load_explicit(&r->deq, memory_order_relaxed);
+    unsigned hw = atomic_load_explicit(&r->high_water, memory_order_relaxed);
+    while (depth > hw &&
+           !atomic_compare_exchange_weak_explicit(&r->high_water, &hw, depth,
+                                                  memory_order_relaxed, memory_order_relaxed))
+        ;
+    return true;
+}
+
+static size_t ring_pop(txq_ring_t *r, char *out)
+{
+    unsigned pos = atomic_load_explicit(&r->deq, memory_order_relaxed);
+    txq_cell_t *cell;
+
+    for (;;) {
+        cell = &r->cells[pos & (TXQ_DEPTH - 1)];
+        unsigned seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        int diff = (int)(seq - (pos + 1));
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&r->deq, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0) {
+            return 0;                                           // empty
+        }
+        else {
+            pos = atomic_load_explicit(&r->deq, memory_order_relaxed);
+        }
+    }
+
+    size_t len = cell->len;
+    memcpy(out, cell->data, len);
+    atomic_store_explicit(&cell->seq, pos + TXQ_DEPTH, memory_order_release);
+    return len;
+}
+
+bool tx_queue_push(tx_queue_t *q, txq_prio_t prio, const char *msg, size_t len)
+{
+    txq_ring_t *r = &q->ring[prio];
+    if (len > TXQ_MSG_MAX) len = TXQ_MSG_MAX;
+    if (len == 0) return true;
+
+    if (!ring_push(r, msg, len)) {
+        atomic_fetch_add_explicit(&r->drops, 1, memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+size_t tx_queue_pop(tx_queue_t *q, char *out)
+{
+    for (int p = 0; p < TXQ_PRIO_COUNT; p++) {
+        size_t len = ring_pop(&q->ring[p], out);
+        if (len) return len;
+    }
+    return 0;
+}
+
+void tx_queue_stats(tx_queue_t *q, txq_stats_t *s)
+{
+    for (int p = 0; p < TXQ_PRIO_COUNT; p++) {
+        txq_ring_t *r = &q->ring[p];
+        s->depth[p] = atomic_load(&r->enq) - atomic_load(&r->deq);
+        s->high_water[p] = atomic_load(&r->high_water);
+        s->drops[p] = atomic_load(&r->drops);
+    }
+}
+
+unsigned tx_queue_room(tx_queue_t *q, txq_prio_t prio)
+{
+    txq_ring_t *r = &q->ring[prio];
+    unsigned depth = atomic_load(&r->enq) - atomic_load(&r->deq);
+    return (depth < TXQ_DEPTH) ? TXQ_DEPTH - depth : 0;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#define TXQ_MSG_MAX   240       // one preformatted line (a MON: frame fits)
+#define TXQ_DEPTH     16        // slots per priority, power of two
+
+typedef enum {
+    TXQ_HIGH = 0,               // command replies, never dropped while there is room
+    TXQ_LOW,                    // telemetry / streams, dropped under backpressure
+    TXQ_PRIO_COUNT
+} txq_prio_t;
+
+typedef struct {
+    atomic_uint seq;
+    uint16_t len;
+    char data[TXQ_MSG_MAX];
+} txq_cell_t;
+
+// Bounded MPMC ring (Vyukov): producers never block, push fails when full
+typedef struct {
+    txq_cell_t cells[TXQ_DEPTH];
+    atomic_uint enq;
+    atomic_uint deq;
+    atomic_uint drops;
+    atomic_uint high_water;
+} txq_ring_t;
+
+typedef struct {
+    txq_ring_t ring[TXQ_PRIO_COUNT];
+} tx_queue_t;
+
+typedef struct {
+    unsigned depth[TXQ_PRIO_COUNT];
+    unsigned high_water[TXQ_PRIO_COUNT];
+    unsigned drops[TXQ_PRIO_COUNT];
+} txq_stats_t;
+
+void tx_queue_init(tx_queue_t *q);
+
+// Any task: copies the message, false (and a drop counted) if it doesn't fit
+bool tx_queue_push(tx_queue_t *q, txq_prio_t prio, const char *msg, size_t len);
+
+// Writer: high priority first; returns the message length, 0 when empty
+size_t tx_queue_pop(tx_queue_t *q, char *out);
+
+void tx_queue_stats(tx_queue_t *q, txq_stats_t *s);
+unsigned tx_queue_room(tx_queue_t *q, txq_prio_t prio);
@@ -1,23 +1,42 @@
 #include "uart_interface.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include <string.h>
 #include <stdlib.h>
 #include "iir_filter.h"
 #include <stdarg.h>
 #include "freertos/semphr.h"
+#include "param_registry.h"
+#include "name_index.h"
+#include "cache_stress.h"
+#include "subscription.h"
+#include "dsp_kernels.h"
+#include "trace.h"
+#include "rtos_wait.h"
+
+#if CONFIG_AUDIO_HOT_IRAM
+#define HOT_IRAM        1
+#else
+#define HOT_IRAM        0
+#endif
+#if CONFIG_AUDIO_CACHE_STRESS
+#define STRESS_ACTIVE   cache_stress_on
+#else
+#define STRESS_ACTIVE   0
+#endif
 
 #define UART_PORT       UART_NUM_0
 #define UART_BAUDRATE   115200
 #define UART_BUF_SIZE   128
+#define UART_TX_BUF     1024    // replies are queued, writers don't wait for the wire
+#define CMD_MAX         512     // SET batches are long lines
+#define SENDF_MAX       256     // longest formatted reply, split into queue messages
 
 static const char *TAG = "UART_IF";
-float fc_current =1000.0f;
-float q_current = 0.707f;
-filter_type_t type_current = FILTER_LOW_PASS;
-const eq_band_t *low, *mid, *high;
 
-
-static SemaphoreHandle_t uart_tx_mutex = NULL;
+static SemaphoreHandle_t uart_tx_mutex = NULL;    // held by the writer and by raw dumps
+static tx_queue_t tx_queue;
+static TaskHandle_t tx_writer = NULL;
 
 void uart_interface_init(void)
 {
@@ -31,18 +50,26 @@ void uart_interface_init(void)
 
     if (!uart_tx_mutex)
         uart_tx_mutex = xSemaphoreCreateMutex();
+    tx_queue_init(&tx_queue);
 
     ESP_ERROR_CHECK(uart_param_config(UART_PORT, &uart_config));
-    ESP_ERROR_CHECK(uart_driver_install(UART_PORT, UART_BUF_SIZE * 2, 0, 0, NULL, 0));
+    ESP_ERROR_CHECK(uart_driver_install(UART_PORT, UART_BUF_SIZE * 2, UART_TX_BUF, 0, NULL, 0));
 
     ESP_LOGI(TAG, "UART initialized at %d baud", UART_BAUDRATE);
 }
 
+bool uart_send(txq_prio_t prio, const char *msg, size_t len)
+{
+    bool ok = tx_queue_push(&tx_queue, prio, msg, len);
+    if (ok && tx_writer) xTaskNotifyGive(tx_writer);
+    return ok;
+}
+
 void uart_sendf(const char *fmt, ...)
 {
     if (fmt == NULL) return;
 
-    char buf[128];
+    char buf[SENDF_MAX];
     va_list ap;
     va_start(ap, fmt);
     int n = vsnprintf(buf, sizeof(buf), fmt, ap);
@@ -51,49 +78,690 @@ void uart_sendf(const char *fmt, ...)
     if (n <= 0) return;
     if (n >= (int)sizeof(buf)) n = (int)sizeof(buf) - 1;
 
+    for (int off = 0; off < n; off += TXQ_MSG_MAX) {
+        int len = (n - off < TXQ_MSG_MAX) ? n - off : TXQ_MSG_MAX;
+        if (!uart_send(TXQ_HIGH, buf + off, len)) break;
+    }
+}
+
+unsigned uart_tx_room(txq_prio_t prio)
+{
+    return tx_queue_room(&tx_queue, prio);
+}
+
+void uart_tx_stats(txq_stats_t *s)
+{
+    tx_queue_stats(&tx_queue, s);
+}
+
+// Single writer: drains replies first, then telemetry
+void uart_tx_task(void *arg)
+{
+    static char msg[TXQ_MSG_MAX];
+    tx_writer = xTaskGetCurrentTaskHandle();
+
+    for (;;)
+    {
+        size_t len = tx_queue_pop(&tx_queue, msg);
+        if (!len) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(20));
+            continue;
+        }
+        xSemaphoreTake(uart_tx_mutex, portMAX_DELAY);
+        TRACE_BEGIN(TRACE_UART_TX);
+        uart_write_bytes(UART_PORT, msg, len);
+        TRACE_END(TRACE_UART_TX);
+        xSemaphoreGive(uart_tx_mutex);
+    }
+}
+
+// ---------------- parameters ----------------
+
+// "KEY=val" / "#id=val" → validated op, tok is modified
+static bool param_parse(char *tok, param_op_t *op, const char **err)
+{
+    char *eq = strchr(tok, '=');
+    if (!eq) { *err = "format"; return false; }
+    *eq = '\0';
+
+    char *end;
+    float v = strtof(eq + 1, &end);
+    if (end == eq + 1) { *err = "value"; return false; }
+    if (!param_lookup(tok, &op->id)) { *err = "unknown"; return false; }
+    if (!param_validate(op->id, &v)) { *err = "range"; return false; }
+    op->value = v;
+    return true;
+}
+
+// Posts the prepared batch; on success the control-side copies follow
+static bool param_commit(dsp_context_t *ctx)
+{
+    param_batch_t *batch = &ctx->params->batch;
+    if (!param_mailbox_post_wait(ctx->params, 100)) return false;
+    for (int i = 0; i < batch->count; i++)
+        param_store(batch->ops[i].id, batch->ops[i].value);
+    return true;
+}
+
+// PARAM:<id>,<name>,<group>,<unit>,<type>,<min>,<max>,<default>,<value>
+static void param_describe(param_id_t id)
+{
+    const param_def_t *d = param_def(id);
+    char msg[128];
+    int n = snprintf(msg, sizeof(msg), "PARAM:%d,%s,%s,%s,%s,%g,%g,%g,%g\r\n",
+                     (int)id, d->name, d->group, d->unit, param_type_to_str(d->type),
+                     d->min, d->max, d->def, param_get(id));
+
+    // a dump is longer than the queue: wait for room instead of dropping
+    while (uart_tx_room(TXQ_HIGH) == 0)
+        vTaskDelay(1);
+    uart_send(TXQ_HIGH, msg, n);
+}
+
+// One-line meter report, shared by telemetry and GET METERS
+static int format_meters(const meter_snapshot_t *m, char *buf, size_t size)
+{
+    return snprintf(buf, size,
+                    "METERS:IPK=%.1f,IRMS=%.1f,OPK=%.1f,OTP=%.1f,ORMS=%.1f,CF=%.1f,"
+                    "GRE=%.1f,GRC=%.1f,GRL=%.1f,CLI=%lu,CLO=%lu\r\n",
+                    m->in_peak_db, m->in_rms_db,
+                    m->out_peak_db, m->out_true_peak_db, m->out_rms_db, m->crest_db,
+                    m->gr_expander_db, m->gr_compressor_db, m->gr_limiter_db,
+                    (unsigned long)m->in_clips, (unsigned long)m->out_clips);
+}
+
+// The audio task adopts a descriptor within one block, retry for a few
+static bool pipeline_commit_wait(dsp_context_t *ctx)
+{
+    deadline_t d = deadline_after_ms(4 * ctx->block_budget_us / 1000);
+    while (!pipeline_commit(ctx->pipeline)) {
+        if (deadline_passed(&d)) return false;
+        vTaskDelay(1);
+    }
+    return true;
+}
+
+static void pipeline_list(const pipeline_t *p)
+{
+    char msg[128];
+    int n = snprintf(msg, sizeof(msg), "PIPE:");
+    for (int i = 0; i < p->count && n < (int)sizeof(msg); i++) {
+        stage_id_t id = p->order[i];
+        n += snprintf(msg + n, sizeof(msg) - n, "%s%s%s", (i ? "," : ""),
+                      stage_name(id), p->bypass[id] ? "(BYP)" : "");
+    }
+    uart_sendf("%s\r\n", msg);
+}
+
+void uart_tx_lock(void)
+{
     xSemaphoreTake(uart_tx_mutex, portMAX_DELAY);
-    uart_write_bytes(UART_PORT, buf, n);
-    uart_wait_tx_done(UART_PORT, pdMS_TO_TICKS(100));
+}
+
+void uart_tx_unlock(void)
+{
     xSemaphoreGive(uart_tx_mutex);
 }
 
+void uart_write_raw(const void *data, size_t len)
+{
+    uart_write_bytes(UART_PORT, data, len);
+}
+
+static uint16_t crc16_ccitt(const uint8_t *p, size_t len, uint16_t crc)
+{
+    while (len--) {
+        crc ^= (uint16_t)(*p++) << 8;
+        for (int i = 0; i < 8; i++)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+void uart_write_frame(uint8_t type, const uint8_t *payload, uint16_t len)
+{
+    uint8_t hdr[5] = { FRAME_SYNC0, FRAME_SYNC1, type, (uint8_t)len, (uint8_t)(len >> 8) };
+
+    uint16_t crc = crc16_ccitt(&hdr[2], 3, 0xFFFF);
+    crc = crc16_ccitt(payload, len, crc);
+    uint8_t tail[2] = { (uint8_t)crc, (uint8_t)(crc >> 8) };
+
+    uart_write_raw(hdr, sizeof(hdr));
+    uart_write_raw(payload, len);
+    uart_write_raw(tail, sizeof(tail));
+}
+
+void uart_set_link_baud(int baud)
+{
+    uart_wait_tx_done(UART_PORT, pdMS_TO_TICKS(1000));
+    uart_set_baudrate(UART_PORT, (baud > 0) ? baud : UART_BAUDRATE);
+}
+
+static void telemetry_send(dsp_context_t *ctx, sub_stream_t stream)
+{
+    static uint32_t meter_seq = 0;
+    static uint32_t pitch_seq = 0;
+    static int tick = 0;
+    char msg[256];
+    int len = 0;
+
+    switch (stream) {
+    case SUB_METERS: {
+        // one window per period, sent once
+        meter_snapshot_t snap;
+        if (!meter_read(ctx->meter, &snap) || snap.seq == meter_seq) return;
+        meter_seq = snap.seq;
+        len = format_meters(&snap, msg, sizeof(msg));
+        break;
+    }
+    case SUB_SPECTRUM:
+        if (!ctx->vad->speech && (tick++ % VAD_SILENCE_DIV) != 0) return;
+        len = snprintf(msg, sizeof(msg),
+                       "STREAM:RMS=%.1f,VAD=%.2f,FFT=%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\r\n",
+                       rms_get_dbfs(ctx->rms_out), ctx->vad->prob,
+                       fft_last_bands[0], fft_last_bands[1], fft_last_bands[2], fft_last_bands[3],
+                       fft_last_bands[4], fft_last_bands[5], fft_last_bands[6], fft_last_bands[7]);
+        break;
+    case SUB_GR:
+        // positive dB like the METERS GR fields
+        len = snprintf(msg, sizeof(msg), "GR:EXP=%.1f,COMP=%.1f,LIM=%.1f,DYN1=%.1f,DYN2=%.1f\r\n",
+                       20.0f * log10f(1.0f / fmaxf(ctx->expd->gain, 1e-5f)),
+                       20.0f * log10f(1.0f / fmaxf(ctx->comp->gain, 1e-5f)),
+                       20.0f * log10f(1.0f / fmaxf(ctx->limiter->gain, 1e-5f)),
+                       0.0f - ctx->dyneq->band[0].gain_db, 0.0f - ctx->dyneq->band[1].gain_db);
+        break;
+    case SUB_STATS: {
+        txq_stats_t st;
+        uart_tx_stats(&st);
+        len = snprintf(msg, sizeof(msg), "STATS:BLOCK=%lu,BUDGET=%lu,OVER=%lu,TXQ=%u,DROP=%u\r\n",
+                       (unsigned long)ctx->block_us, (unsigned long)ctx->block_budget_us,
+                       (unsigned long)ctx->overruns, st.depth[TXQ_LOW], st.drops[TXQ_LOW]);
+        break;
+    }
+    case SUB_PITCH: {
+        // latest analysis, sent once
+        pitch_result_t r;
+        if (!pitch_tracker_read(ctx->pitch, &r) || r.seq == pitch_seq) return;
+        pitch_seq = r.seq;
+        len = snprintf(msg, sizeof(msg), "PITCH:F0=%.1f,CONF=%.2f,VOICED=%d\r\n",
+                       r.f0_hz, r.clarity, r.voiced ? 1 : 0);
+        break;
+    }
+    default:
+        return;
+    }
+    uart_send(TXQ_LOW, msg, len);
+}
+
+// Sends every subscribed stream on its own period, sleeps while nobody listens
 void telemetry_task(void *arg)
 {
-    dsp_context_t *ctx = (dsp_context_t *)arg;   
-    const int delay_ms = 100; // send frequency (5 Hz)
+    dsp_context_t *ctx = (dsp_context_t *)arg;
+    TickType_t due[SUB_COUNT] = {0};
+
     while (1)
     {
-        float rms_db = rms_get_dbfs(ctx->rms_out);
+        if (sub_expire()) {
+            monitor_enable(ctx->monitor, false, 0);
+            ESP_LOGI(TAG, "Host silent for %d ms, telemetry off", SUB_TTL_MS);
+        }
 
-        // Generate message for GUI
-        char msg[256];
-        int len = snprintf(msg, sizeof(msg),
-                           "STREAM:RMS=%.1f,FFT=%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\r\n",
-                           rms_db,
-                           fft_last_bands[0], fft_last_bands[1], fft_last_bands[2], fft_last_bands[3],
-                           fft_last_bands[4], fft_last_bands[5], fft_last_bands[6], fft_last_bands[7]);
+        TickType_t now = xTaskGetTickCount();
+        TickType_t sleep = pdMS_TO_TICKS(100);
+        for (int s = 0; s < SUB_COUNT; s++) {
+            unsigned hz = sub_rate((sub_stream_t)s);
+            if (!hz) continue;
+
+            if ((int32_t)(now - due[s]) >= 0) {
+                TRACE_BEGIN(TRACE_TELEMETRY);
+                telemetry_send(ctx, (sub_stream_t)s);
+                TRACE_END(TRACE_TELEMETRY);
+                TickType_t period = pdMS_TO_TICKS(1000 / hz);
+                due[s] = now + (period ? period : 1);
+            }
+            if (due[s] - now < sleep) sleep = due[s] - now;
+        }
+        vTaskDelay(sleep ? sleep : 1);
+    }
+}
 
-        uart_write_bytes(UART_PORT, msg, len);
+// ---------------- commands ----------------
+
+typedef void (*cmd_fn_t)(dsp_context_t *ctx, char *args);
+
+typedef struct {
+    const char *verb;
+    cmd_fn_t fn;
+    const char *usage;
+} uart_cmd_t;
+
+static void cmd_help(dsp_context_t *ctx, char *args);
+
+static void cmd_ping(dsp_context_t *ctx, char *args)
+{
+    uart_sendf("pong\r\n");
+}
+
+static void cmd_req_rms(dsp_context_t *ctx, char *args)
+{
+    uart_sendf("RMS_DB=%.1f\r\n", rms_get_dbfs(ctx->rms_out));
+}
+
+static void cmd_get(dsp_context_t *ctx, char *args)
+{
+    param_id_t id;
+
+    if (strcasecmp(args, "METERS") == 0) {
+        meter_snapshot_t snap;
+        if (!sub_rate(SUB_METERS)) uart_sendf("Meters off (SUB METERS=<hz>)\r\n");
+        else if (meter_read(ctx->meter, &snap)) {
+            char msg[160];
+            int n = format_meters(&snap, msg, sizeof(msg));
+            uart_send(TXQ_HIGH, msg, n);
+        }
+        else uart_sendf("Meters not ready\r\n");
+    }
+    else if (strcasecmp(args, "VAD") == 0) {
+        vad_t *v = ctx->vad;
+        uart_sendf("VAD:STATE=%s,P=%.2f,E=%.1f,NF=%.1f,ZCR=%.3f,SFM=%.2f,BR=%.2f,KEY=%d\r\n",
+                   vad_state_to_str(v->state), v->prob, v->energy_db, v->noise_db,
+                   v->zcr, v->flatness, v->band_ratio, ctx->expd->key_enabled);
+    }
+    else if (strcasecmp(args, "TXQ") == 0) {
+        txq_stats_t st;
+        uart_tx_stats(&st);
+        uart_sendf("TXQ:HI=%u/%u,LO=%u/%u,PEAK_HI=%u,PEAK_LO=%u,DROP_HI=%u,DROP_LO=%u\r\n",
+                   st.depth[TXQ_HIGH], TXQ_DEPTH, st.depth[TXQ_LOW], TXQ_DEPTH,
+                   st.high_water[TXQ_HIGH], st.high_water[TXQ_LOW],
+                   st.drops[TXQ_HIGH], st.drops[TXQ_LOW]);
+    }
+    else if (strcasecmp(args, "DYN") == 0) {
+        const dyn_eq_t *d = ctx->dyneq;
+        uart_sendf("DYN:GR1=%.1f,GR2=%.1f,ON=%d%d\r\n", d->band[0].gain_db, d->band[1].gain_db,
+                   d->band[0].enabled, d->band[1].enabled);
+    }
+    else if (strcasecmp(args, "TIMING") == 0) {
+        // worst case restarts with every read
+        uint32_t max = ctx->block_us_max;
+        ctx->block_us_max = 0;
+        uart_sendf("TIMING:LAST=%lu,MAX=%lu,BUDGET=%lu,OVER=%lu,IRAM=%d,STRESS=%d\r\n",
+                   (unsigned long)ctx->block_us, (unsigned long)max,
+                   (unsigned long)ctx->block_budget_us,
+                   (unsigned long)ctx->overruns, HOT_IRAM, (int)STRESS_ACTIVE);
+    }
+    else if (param_lookup(args, &id)) {
+        param_describe(id);
+    }
+    else {
+        // a group name lists all of its parameters (GET EQ, GET COMP, ...)
+        bool found = false;
+        for (int i = 0; i < PARAM_COUNT; i++) {
+            if (strcasecmp(param_def((param_id_t)i)->group, args) == 0) {
+                param_describe((param_id_t)i);
+                found = true;
+            }
+        }
+        if (!found) uart_sendf("Unknown GET %s\r\n", args);
+    }
+}
+
+static void cmd_dump(dsp_context_t *ctx, char *args)
+{
+    for (int i = 0; i < PARAM_COUNT; i++)
+        param_describe((param_id_t)i);
+    uart_sendf("PARAM:END,%d\r\n", PARAM_COUNT);
+}
+
+static void cmd_set(dsp_context_t *ctx, char *args)
+{
+    param_batch_t *batch = &ctx->params->batch;
+    unsigned long seq;
+    int off = 0;
+    if (sscanf(args, "%lu %n", &seq, &off) != 1 || off == 0) {
+        uart_sendf("NAK ? format\r\n");
+        return;
+    }
+
+    // parse everything first: the batch is applied whole or not at all
+    batch->count = 0;
+    char *save = NULL;
+    for (char *tok = strtok_r(args + off, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        const char *err;
+        if (batch->count >= PARAM_BATCH_MAX) { uart_sendf("NAK %lu too many\r\n", seq); return; }
+        if (!param_parse(tok, &batch->ops[batch->count], &err)) {
+            uart_sendf("NAK %lu %s %s\r\n", seq, err, tok);
+            return;
+        }
+        batch->count++;
+    }
+
+    if (!param_commit(ctx)) uart_sendf("NAK %lu busy\r\n", seq);
+    else uart_sendf("ACK %lu %d\r\n", seq, batch->count);
+}
+
+static void cmd_preset(dsp_context_t *ctx, char *args)
+{
+    int count;
+    const param_op_t *ops = param_preset(args, &count);
+    if (!ops) { uart_sendf("Unknown PRESET %s\r\n", args); return; }
+
+    param_batch_t *batch = &ctx->params->batch;
+    memcpy(batch->ops, ops, count * sizeof(*ops));
+    batch->count = count;
+    if (!param_commit(ctx)) { uart_sendf("Busy\r\n"); return; }
+    uart_sendf("OK PRESET %s %d\r\n", args, count);
+    for (int i = 0; i < count; i++)
+        param_describe(ops[i].id);      // lets the GUI follow
+}
+
+static void cmd_pipe(dsp_context_t *ctx, char *args)
+{
+    if (strcasecmp(args, "LIST") == 0) {
+        pipeline_list(ctx->pipeline);
+    }
+
+    else if (strncasecmp(args, "ORDER=", 6) == 0) {
+        stage_id_t order[STAGE_COUNT];
+        int count = 0;
+        char *save = NULL;
+        for (char *tok = strtok_r(args + 6, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+            if (count >= STAGE_COUNT || !stage_from_name(tok, &order[count++])) {
+                count = -1;
+                break;
+            }
+        }
+        if (count < 0 || !pipeline_set_order(ctx->pipeline, order, count)) {
+            uart_sendf("Invalid PIPE order (list every stage once)\r\n");
+            return;
+        }
+        if (!pipeline_commit_wait(ctx)) { uart_sendf("PIPE busy\r\n"); return; }
+        pipeline_list(ctx->pipeline);
+    }
+
+    else if (strncasecmp(args, "BYPASS ", 7) == 0) {
+        char name[16];
+        int on;
+        stage_id_t id;
+        if (sscanf(args + 7, "%15[^=]=%d", name, &on) != 2 || !stage_from_name(name, &id)) {
+            uart_sendf("Invalid PIPE BYPASS format\r\n");
+            return;
+        }
+        if (!pipeline_set_bypass(ctx->pipeline, id, on != 0)) {
+            uart_sendf("Stage %s cannot be bypassed\r\n", stage_name(id));
+            return;
+        }
+        if (!pipeline_commit_wait(ctx)) { uart_sendf("PIPE busy\r\n"); return; }
+        pipeline_list(ctx->pipeline);
+    }
+
+    else if (strncasecmp(args, "STATIC ", 7) == 0) {
+        // precompiled variants on/off, for A/B timing against the generic loop
+        pipeline_use_variants(ctx->pipeline, atoi(args + 7) != 0);
+        if (!pipeline_commit_wait(ctx)) { uart_sendf("PIPE busy\r\n"); return; }
+        uart_sendf("OK PIPE STATIC=%d\r\n", ctx->pipeline->use_variants);
+    }
+
+    else uart_sendf("Invalid PIPE command\r\n");
+}
+
+static void cmd_capture(dsp_context_t *ctx, char *args)
+{
+    capture_t *c = ctx->capture;
+
+    if (strcasecmp(args, "STATUS") == 0) {
+        uart_sendf("CAPTURE:STATE=%s,MODE=0x%02x,REASON=0x%02x,BLOCKS=%lu/%lu,DROPPED=%lu,MEM=%s\r\n",
+                   capture_state_to_str(c->state), c->mode, c->reason,
+                   (unsigned long)c->written, (unsigned long)c->capacity,
+                   (unsigned long)c->dropped, c->in_psram ? "PSRAM" : "INTERNAL");
+    }
+
+    else if (strncasecmp(args, "ARM", 3) == 0) {
+        uint8_t mode = CAPTURE_TRIG_MANUAL;
+        char *save = NULL;
+        for (char *tok = strtok_r(args + 3, " ,", &save); tok; tok = strtok_r(NULL, " ,", &save)) {
+            if      (strcasecmp(tok, "CLIP")     == 0) mode |= CAPTURE_TRIG_CLIP;
+            else if (strcasecmp(tok, "DEADLINE") == 0) mode |= CAPTURE_TRIG_DEADLINE;
+            else if (strcasecmp(tok, "MANUAL")   != 0) { uart_sendf("Invalid CAPTURE trigger\r\n"); return; }
+        }
+        capture_arm(c, mode);
+        uart_sendf("OK CAPTURE ARM 0x%02x\r\n", mode);
+    }
+
+    else if (strcasecmp(args, "TRIGGER") == 0) {
+        capture_trigger(c);
+        uart_sendf("OK CAPTURE TRIGGER\r\n");
+    }
+
+    else if (strncasecmp(args, "DUMP", 4) == 0) {
+        capture_request_dump(c, atoi(args + 4));
+    }
+
+    else uart_sendf("Invalid CAPTURE command\r\n");
+}
+
+static void cmd_monitor(dsp_context_t *ctx, char *args)
+{
+    if (strncasecmp(args, "ON", 2) == 0) {
+        int rate = atoi(args + 2);
+        if (rate > MONITOR_MAX_RATE) { uart_sendf("Invalid MONITOR rate (max %d)\r\n", MONITOR_MAX_RATE); return; }
+        monitor_enable(ctx->monitor, true, rate);
+        uart_sendf("OK MONITOR ON\r\n");
+    }
+    else if (strcasecmp(args, "OFF") == 0) {
+        monitor_enable(ctx->monitor, false, 0);
+        uart_sendf("OK MONITOR OFF\r\n");
+    }
+    else uart_sendf("Invalid MONITOR command\r\n");
+}
+
+static void cmd_rate(dsp_context_t *ctx, char *args)
+{
+    if (!*args) { uart_sendf("RATE=%lu\r\n", (unsigned long)ctx->sample_rate); return; }
+
+    uint32_t fs = (uint32_t)atoi(args);
+    if (fs != 16000 && fs != 32000 && fs != 48000) { uart_sendf("Invalid RATE (16000|32000|48000)\r\n"); return; }
+    if (fs == ctx->sample_rate) { uart_sendf("OK RATE=%lu\r\n", (unsigned long)fs); return; }
+
+    // the audio task switches between two blocks, monitor / pitch / capture
+    // included, then reports the new rate
+    ctx->rate_request = fs;
+    deadline_t d = deadline_after_ms(200);
+    while (ctx->sample_rate != fs && !deadline_passed(&d))
+        vTaskDelay(1);
+    if (ctx->sample_rate != fs) { uart_sendf("NAK RATE timeout\r\n"); return; }
+
+    uart_sendf("OK RATE=%lu\r\n", (unsigned long)fs);
+}
+
+// PITCH [HOP=<ms>]: hop and analysis cost, worst case restarts with every read
+static void cmd_pitch(dsp_context_t *ctx, char *args)
+{
+    pitch_tracker_t *t = ctx->pitch;
+    if (strncasecmp(args, "HOP=", 4) == 0) {
+        float hop = strtof(args + 4, NULL);
+        if (hop < PITCH_HOP_MS_MIN || hop > PITCH_HOP_MS_MAX) {
+            uart_sendf("Invalid PITCH hop (%.0f..%.0f ms)\r\n", PITCH_HOP_MS_MIN, PITCH_HOP_MS_MAX);
+            return;
+        }
+        // the tracker picks it up within one idle (50 ms) or data wait
+        pitch_tracker_set_hop(t, hop);
+        deadline_t d = deadline_after_ms(200);
+        while (t->request_hop > 0.0f && !deadline_passed(&d))
+            vTaskDelay(1);
+    }
+    else if (*args) { uart_sendf("Invalid PITCH command\r\n"); return; }
+
+    uint32_t max = t->us_max;
+    t->us_max = 0;
+    uart_sendf("PITCH:HOP=%.1f,RATE=%.0f,US=%lu,MAX_US=%lu,BUDGET_US=%d,OVER=%lu,SKIPPED=%lu,LATE=%lu\r\n",
+               t->pitch.hop_ms, t->pitch.rate, (unsigned long)t->us_last, (unsigned long)max,
+               PITCH_BUDGET_US, (unsigned long)t->over_budget,
+               (unsigned long)t->pitch.skipped, (unsigned long)t->late);
+}
+
+static void sub_list(void)
+{
+    char msg[128];
+    int n = snprintf(msg, sizeof(msg), "SUB:");
+    for (int i = 0; i < SUB_COUNT; i++)
+        n += snprintf(msg + n, sizeof(msg) - n, "%s=%u,", sub_name((sub_stream_t)i), sub_rate((sub_stream_t)i));
+    uart_sendf("%sTTL=%d\r\n", msg, SUB_TTL_MS);
+}
 
-        vTaskDelay(pdMS_TO_TICKS(delay_ms));
+static void cmd_sub(dsp_context_t *ctx, char *args)
+{
+    if (strcasecmp(args, "OFF") == 0) sub_clear();
+
+    else if (*args) {
+        // parse everything first, like SET
+        sub_stream_t ids[SUB_COUNT];
+        unsigned hz[SUB_COUNT];
+        int count = 0;
+        char *save = NULL;
+        for (char *tok = strtok_r(args, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+            char *eq = strchr(tok, '=');
+            if (eq) *eq = '\0';
+            if (count >= SUB_COUNT || !eq || !sub_from_name(tok, &ids[count])) {
+                uart_sendf("Invalid SUB stream %s\r\n", tok);
+                return;
+            }
+            hz[count] = (unsigned)atoi(eq + 1);
+            if (hz[count] > SUB_HZ_MAX) { uart_sendf("Invalid SUB rate (0..%d Hz)\r\n", SUB_HZ_MAX); return; }
+            count++;
+        }
+        for (int i = 0; i < count; i++)
+            sub_set(ids[i], hz[i]);
     }
+
+    sub_list();
+}
+
+static int64_t kernels_now_ns(void)
+{
+    return esp_timer_get_time() * 1000;
+}
+
+static void kernels_report(const dsp_kernel_result_t *r)
+{
+    uart_sendf("KERNEL:%s,ERR=%.2g,%s,REF_NS=%.0f,NS=%.0f\r\n", r->name, r->max_err,
+               r->ok ? "OK" : "FAIL", r->ref_ns, r->backend_ns);
+}
+
+// Cross-check and time the compiled kernel backend, runs on this task
+static void cmd_kernels(dsp_context_t *ctx, char *args)
+{
+    int n = (*args) ? atoi(args) : CONFIG_AUDIO_BLOCK_SIZE;
+    if (n < 1 || n > 1024) { uart_sendf("Invalid KERNELS length\r\n"); return; }
+    uart_sendf("KERNELS:BACKEND=%s,N=%d\r\n", dsp_kernels_backend(), n);
+    int failed = dsp_kernels_check(n, 200, kernels_now_ns, kernels_report);
+    uart_sendf("%s KERNELS\r\n", failed ? "FAIL" : "OK");
+}
+
+#if CONFIG_AUDIO_CACHE_STRESS
+static void cmd_stress(dsp_context_t *ctx, char *args)
+{
+    if (strcasecmp(args, "ON") == 0)       cache_stress_on = true;
+    else if (strcasecmp(args, "OFF") == 0) cache_stress_on = false;
+    else { uart_sendf("Invalid STRESS command\r\n"); return; }
+    ctx->block_us_max = 0;
+    uart_sendf("OK STRESS %s\r\n", cache_stress_on ? "ON" : "OFF");
+}
+#endif
+
+#if CONFIG_AUDIO_TRACE
+static void cmd_trace(dsp_context_t *ctx, char *args)
+{
+    if (strcasecmp(args, "ON") == 0)            trace_start();
+    else if (strcasecmp(args, "OFF") == 0)      trace_stop();
+    else if (strncasecmp(args, "DUMP", 4) == 0) { trace_dump(atoi(args + 4)); return; }
+    else if (*args && strcasecmp(args, "STATUS") != 0) { uart_sendf("Invalid TRACE command\r\n"); return; }
+
+    uart_sendf("TRACE:%s,EVENTS=%d,C0=%lu,C1=%lu\r\n", trace_running() ? "ON" : "OFF",
+               CONFIG_AUDIO_TRACE_EVENTS, (unsigned long)trace_count(0),
+               (unsigned long)((portNUM_PROCESSORS > 1) ? trace_count(1) : 0));
+}
+#endif
+
+static const uart_cmd_t commands[] = {
+    { "HELP",    cmd_help,    "help                          - show this help" },
+    { "PING",    cmd_ping,    "ping                          - check connection" },
+    { "REQ_RMS", cmd_req_rms, "REQ_RMS                       - read current RMS" },
+    { "GET",     cmd_get,     "GET <METERS|VAD|DYN|TXQ|TIMING|param|group> - read state / parameters" },
+    { "DUMP",    cmd_dump,    "DUMP                          - describe every parameter" },
+    { "SET",     cmd_set,     "SET <seq> <KEY|#id>=<val>,... - apply params in one block, ACK <seq>" },
+    { "PRESET",  cmd_preset,  "PRESET DEESS                  - apply a named parameter set" },
+    { "PIPE",    cmd_pipe,    "PIPE LIST | ORDER=<st>,... | BYPASS <st>=<0|1> | STATIC <0|1>" },
+    { "CAPTURE", cmd_capture, "CAPTURE STATUS | ARM [CLIP,DEADLINE] | TRIGGER | DUMP [baud]" },
+    { "MONITOR", cmd_monitor, "MONITOR ON [rate] | OFF       - ADPCM audio monitor stream (rate <= 8000)" },
+    { "SUB",     cmd_sub,     "SUB [<stream>=<hz>,... | OFF] - METERS|SPECTRUM|GR|STATS|PITCH, lapses after 5 s of host silence" },
+    { "PITCH",   cmd_pitch,   "PITCH [HOP=<ms>]              - F0 tracker hop / cost (values via SUB PITCH=<hz>)" },
+    { "KERNELS", cmd_kernels, "KERNELS [n]                   - check / time the block kernel backend" },
+#if CONFIG_AUDIO_TRACE
+    { "TRACE",   cmd_trace,   "TRACE ON | OFF | STATUS | DUMP [baud] - task / DSP stage trace" },
+#endif
+#if CONFIG_AUDIO_CACHE_STRESS
+    { "STRESS",  cmd_stress,  "STRESS ON | OFF               - flash cache thrasher on core 0" },
+#endif
+    { "RATE",    cmd_rate,    "RATE [16000|32000|48000]      - read / switch the sample rate" },
+};
+
+#define CMD_COUNT  (sizeof(commands) / sizeof(commands[0]))
+
+static name_index_t cmd_index;
+
+static void cmd_help(dsp_context_t *ctx, char *args)
+{
+    uart_sendf("\r\nCommands:\r\n");
+    for (size_t i = 0; i < CMD_COUNT; i++)
+        uart_sendf("  %s\r\n", commands[i].usage);
+    uart_sendf("  <KEY|#id>=<val>               - set one parameter (see DUMP)\r\n\r\n");
+}
+
+// Single "KEY=val" line, kept for terminals and older GUIs
+static void cmd_param_line(dsp_context_t *ctx, char *line)
+{
+    param_batch_t *batch = &ctx->params->batch;
+    char key[32];
+    const char *err;
+    snprintf(key, sizeof(key), "%.*s", (int)strcspn(line, "="), line);
+
+    if (!param_parse(line, &batch->ops[0], &err)) { uart_sendf("Invalid param %s (%s)\r\n", key, err); return; }
+    batch->count = 1;
+    if (!param_commit(ctx)) { uart_sendf("Busy\r\n"); return; }
+    uart_sendf("OK %s=%g\r\n", key, batch->ops[0].value);
+}
+
+static void uart_dispatch(dsp_context_t *ctx, char *line)
+{
+    // verb = first word, the rest goes to the handler
+    size_t vlen = strcspn(line, " ");
+    char *args = line + vlen;
+    if (*args) *args++ = '\0';
+    while (*args == ' ') args++;
+
+    // any line from the host keeps its subscriptions alive
+    sub_keepalive();
+
+    uint16_t i;
+    if (name_index_find(&cmd_index, line, &i)) commands[i].fn(ctx, args);
+    else if (strchr(line, '='))                cmd_param_line(ctx, line);
+    else                                       uart_sendf("Unknown command\r\n");
 }
 
 void uart_interface_task_ui(void *arg)
 {
     dsp_context_t *ctx = (dsp_context_t *)arg;
-    static char cmd_buf[128];
+    static char cmd_buf[CMD_MAX];
     size_t idx = 0;
     uint8_t rx[64];
 
+    name_index_clear(&cmd_index);
+    for (size_t i = 0; i < CMD_COUNT; i++)
+        name_index_add(&cmd_index, commands[i].verb, (uint16_t)i);
+
     const char *prompt = "> ";
     uart_sendf("%s", prompt);
 
-    expander_t   *expd   = ctx->expd;
-    compressor_t *comp   = ctx->comp;
-    limiter_t    *limitr = ctx->limiter;
-    rms_filter_t *rmsout = ctx->rms_out;
-
     for (;;)
     {
         int len = uart_read_bytes(UART_PORT, rx, sizeof(rx), pdMS_TO_TICKS(50));
@@ -105,110 +773,7 @@ void uart_interface_task_ui(void *arg)
             if (c == '\r' || c == '\n')
             {
                 cmd_buf[idx] = '\0';
-
-                if (idx > 0)
-                {
-                    // ---------------- HELP ----------------
-                    if (strcasecmp(cmd_buf, "help") == 0) {
-                        uart_sendf(
-                            "\r\nCommands:\r\n"
-                            "  help                       - show this help\r\n"
-                            "  ping                       - check connection\r\n"
-                            "  get eq                     - show EQ status\r\n"
-                            "  REQ_RMS                    - read current RMS\r\n"
-                            "  EQ_<LOW|MID|HIGH>_<FC|Q|GAIN>=<val>\r\n"
-                            "  EXPANDER_<THRESHOLD|RATIO|ATTACK|RELEASE|HOLD>=<val>\r\n"
-                            "  COMP_<THRESHOLD|RATIO|MAKEUP|ATTACK|RELEASE|KNEE>=<val>\r\n"
-                            "  LIMIT_<THRESHOLD|ATTACK|RELEASE>=<val>\r\n\r\n");
-                    }
-
-                    // ---------------- PING ----------------
-                    else if (strcasecmp(cmd_buf, "ping") == 0) {
-                        uart_sendf("pong\r\n");
-                    }
-
-                    // ---------------- EQ ----------------
-                    else if (strncasecmp(cmd_buf, "EQ_", 3) == 0) {
-                        char band[8], param[8];
-                        float value;
-                        if (sscanf(cmd_buf, "EQ_%7[^_]_%7[^=]=%f", band, param, &value) == 3) {
-                            eq_band_id_t id;
-                            if      (strcasecmp(band, "LOW")  == 0) id = EQ_BAND_LOW;
-                            else if (strcasecmp(band, "MID")  == 0) id = EQ_BAND_MID;
-                            else if (strcasecmp(band, "HIGH") == 0) id = EQ_BAND_HIGH;
-                            else { uart_sendf("Invalid EQ band\r\n"); goto end_prompt; }
-
-                            eq_band_t *target = eq_get_band(id);
-                            if (!target) { uart_sendf("EQ band not found\r\n"); goto end_prompt; }
-
-                            if      (strcasecmp(param, "FC")   == 0) target->fc      = value;
-                            else if (strcasecmp(param, "Q")    == 0) target->Q       = value;
-                            else if (strcasecmp(param, "GAIN") == 0) target->gain_db = value;
-                            else { uart_sendf("Invalid EQ param\r\n"); goto end_prompt; }
-
-                            update_filter_coefficients_eq(target);
-                            uart_sendf("OK EQ_%s_%s=%.2f\r\n", band, param, value);
-                        }
-                        else uart_sendf("Invalid EQ format\r\n");
-                    }
-
-                    // ---------------- EXPANDER ----------------
-                    else if (strncasecmp(cmd_buf, "EXPANDER_", 9) == 0) {
-                        char param[16];
-                        float value;
-                        if (sscanf(cmd_buf, "EXPANDER_%15[^=]=%f", param, &value) == 2) {
-                            if      (strcasecmp(param, "THRESHOLD") == 0) expd->threshold     = value;
-                            else if (strcasecmp(param, "RATIO")     == 0) expd->ratio         = value;
-                            else if (strcasecmp(param, "ATTACK")    == 0) expd->attack_coeff  = value;
-                            else if (strcasecmp(param, "RELEASE")   == 0) expd->release_coeff = value;
-                            else if (strcasecmp(param, "HOLD")      == 0) expd->hold_time     = value;
-                            else { uart_sendf("Invalid EXP param\r\n"); goto end_prompt; }
-                            uart_sendf("OK EXPANDER\r\n");
-                        } else uart_sendf("Invalid EXP format\r\n");
-                    }
-
-                    // ---------------- COMPRESSOR ----------------
-                    else if (strncasecmp(cmd_buf, "COMP_", 5) == 0) {
-                        char param[16];
-                        float value;
-                        if (sscanf(cmd_buf, "COMP_%15[^=]=%f", param, &value) == 2) {
-                            if      (strcasecmp(param, "THRESHOLD") == 0) comp->threshold     = value;
-                            else if (strcasecmp(param, "RATIO")     == 0) comp->ratio         = value;
-                            else if (strcasecmp(param, "MAKEUP")    == 0) comp->makeup        = value;
-                            else if (strcasecmp(param, "ATTACK")    == 0) comp->attack_coeff  = value;
-                            else if (strcasecmp(param, "RELEASE")   == 0) comp->release_coeff = value;
-                            else if (strcasecmp(param, "KNEE")      == 0) comp->knee_db       = value;
-                            else { uart_sendf("Invalid COMP param\r\n"); goto end_prompt; }
-                            uart_sendf("OK COMP\r\n");
-                        } else uart_sendf("Invalid COMP format\r\n");
-                    }
-
-                    // ---------------- LIMITER ----------------
-                    else if (strncasecmp(cmd_buf, "LIMIT_", 6) == 0) {
-                        char param[16];
-                        float value;
-                        if (sscanf(cmd_buf, "LIMIT_%15[^=]=%f", param, &value) == 2) {
-                            if      (strcasecmp(param, "THRESHOLD") == 0) limitr->threshold = value;
-                            else if (strcasecmp(param, "ATTACK")    == 0) limitr->attack    = value;
-                            else if (strcasecmp(param, "RELEASE")   == 0) limitr->release   = value;
-                            else { uart_sendf("Invalid LIMIT param\r\n"); goto end_prompt; }
-                            uart_sendf("OK LIMIT\r\n");
-                        } else uart_sendf("Invalid LIMIT format\r\n");
-                    }
-
-                    // ---------------- RMS REQUEST ----------------
-                    else if (strcasecmp(cmd_buf, "REQ_RMS") == 0) {
-                        float db = rms_get_dbfs(rmsout);
-                        uart_sendf("RMS_DB=%.1f\r\n", db);
-                    }
-
-                    // ---------------- UNKNOWN ----------------
-                    else {
-                        uart_sendf("Unknown command\r\n");
-                    }
-                }
-
-            end_prompt:
+                if (idx > 0) uart_dispatch(ctx, cmd_buf);
                 idx = 0;
                 //uart_sendf("%s", prompt);
                 continue;
@@ -230,4 +795,4 @@ void uart_interface_task_ui(void *arg)
             }
         }
     }
-}
\ No newline at end of file
+}
@@ -11,6 +11,15 @@
 #include "rms.h"
 #include "iir_filter.h"
 #include "fft.h"
+#include "meter.h"
+#include "vad.h"
+#include "pipeline.h"
+#include "dyn_eq.h"
+#include "capture.h"
+#include "monitor_stream.h"
+#include "pitch_tracker.h"
+#include "param_batch.h"
+#include "tx_queue.h"
 
 
 typedef struct {
@@ -18,11 +27,44 @@ typedef struct {
     compressor_t *comp;
     limiter_t *limiter;
     rms_filter_t *rms_out;
+    dyn_eq_t *dyneq;
     eq3band_t *eq;
+    meter_t *meter;
+    vad_t *vad;
+    pipeline_t *pipeline;
+    capture_t *capture;
+    monitor_t *monitor;
+    pitch_tracker_t *pitch;
+    param_mailbox_t *params;
+    volatile uint32_t sample_rate;      // current I2S rate, written by the audio task
+    volatile uint32_t rate_request;     // > 0: switch at the next block boundary
+    volatile uint32_t block_budget_us;  // I2S period of one block
+    volatile uint32_t block_us;         // DSP time of the last block
+    volatile uint32_t block_us_max;     // worst case since the last GET TIMING
+    volatile uint32_t overruns;         // blocks over the I2S period
 } dsp_context_t;
 
 void uart_interface_init(void);
 void uart_interface_task_ui(void *arg);
-void uart_sendf(const char *fmt, ...);
 void telemetry_task(void *arg);
 
+// All text output goes through the TX queue and never blocks the caller;
+// uart_tx_task() is the only writer. uart_sendf() replies are high priority.
+void uart_sendf(const char *fmt, ...);
+bool uart_send(txq_prio_t prio, const char *msg, size_t len);
+unsigned uart_tx_room(txq_prio_t prio);
+void uart_tx_stats(txq_stats_t *s);
+void uart_tx_task(void *arg);
+
+// Raw access for framed/binary output (capture dump), uart_write_raw() requires
+// the lock; the writer task pauses while it is held
+void uart_tx_lock(void);
+void uart_tx_unlock(void);
+void uart_write_raw(const void *data, size_t len);
+void uart_set_link_baud(int baud);   // 0 restores the default rate
+
+// A5 5A | type | len (u16 LE) | payload | crc16-ccitt (u16 LE), lock held
+#define FRAME_SYNC0     0xA5
+#define FRAME_SYNC1     0x5A
+void uart_write_frame(uint8_t type, const uint8_t *payload, uint16_t len);
+
@@ -0,0 +1,63 @@
+#include "adpcm.h"
+
+static const int8_t index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static const int16_t step_table[89] = {
+        7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+       19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+       50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+      130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+      337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+      876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+     2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+     5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+void adpcm_reset(adpcm_state_t *s)
+{
+    s->predictor = 0;
+    s->index = 0;
+}
+
+static uint8_t adpcm_encode_sample(adpcm_state_t *s, int16_t sample)
+{
+    int step = step_table[s->index];
+    int diff = sample - s->predictor;
+    uint8_t code = 0;
+
+    if (diff < 0) { code = 8; diff = -diff; }
+
+    int vpdiff = step >> 3;
+    if (diff >= step) { code |= 4; diff -= step; vpdiff += step; }
+    step >>= 1;
+    if (diff >= step) { code |= 2; diff -= step; vpdiff += step; }
+    step >>= 1;
+    if (diff >= step) { code |= 1; vpdiff += step; }
+
+    int pred = s->predictor + ((code & 8) ? -vpdiff : vpdiff);
+    if (pred > 32767)  pred = 32767;
+    if (pred < -32768) pred = -32768;
+    s->predictor = (int16_t)pred;
+
+    int idx = s->index + index_table[code];
+    if (idx < 0)  idx = 0;
+    if (idx > 88) idx = 88;
+    s->index = (uint8_t)idx;
+
+    return code;
+}
+
+size_t adpcm_encode(adpcm_state_t *s, const int16_t *in, int n, uint8_t *out)
+{
+    size_t bytes = 0;
+    for (int i = 0; i < n; i += 2) {
+        uint8_t lo = adpcm_encode_sample(s, in[i]);
+        uint8_t hi = (i + 1 < n) ? adpcm_encode_sample(s, in[i + 1]) : 0;
+        out[bytes++] = (uint8_t)(lo | (hi << 4));
+    }
+    return bytes;
+}
@@ -0,0 +1,18 @@
+#ifndef ADPCM_H
+#define ADPCM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// IMA-ADPCM, 4 bits/sample, low nibble first (same packing as IMA WAV)
+typedef struct {
+    int16_t predictor;
+    uint8_t index;
+} adpcm_state_t;
+
+void   adpcm_reset(adpcm_state_t *s);
+
+// n samples → (n + 1) / 2 bytes, returns bytes written
+size_t adpcm_encode(adpcm_state_t *s, const int16_t *in, int n, uint8_t *out);
+
+#endif // ADPCM_H
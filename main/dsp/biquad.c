@@ -0,0 +1,106 @@
+#include "biquad.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+bool is_biquad_stable(float a1, float a2)
+{
+    if (fabsf(a2) >= 1.0f) return false;
+    if (a1 <= -1.0f - a2) return false;
+    if (a1 >= 1.0f + a2) return false;     // |a1| < 1 + a2
+    return true;
+}
+
+bool biquad_design(filter_type_t type, float fc, float Q, float gain_db, float fs,
+                   biquad_coeffs_t *c)
+{
+    float a0 = 1.0f, a1 = 0.0f, a2 = 0.0f;
+    float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+
+    const float w0    = 2.0f * (float)M_PI * fc / fs;
+    const float cosw0 = cosf(w0);
+    const float sinw0 = sinf(w0);
+    const float alpha = sinw0 / (2.0f * Q);
+    const float A     = powf(10.0f, gain_db / 40.0f);  // linéaire
+    
+    switch (type) {
+        case FILTER_LOW_PASS:
+            b0 = (1.0f - cosw0) * 0.5f;
+            b1 = 1.0f - cosw0;
+            b2 = (1.0f - cosw0) * 0.5f;
+            a0 = 1.0f + alpha;
+            a1 = -2.0f * cosw0;
+            a2 = 1.0f - alpha;
+            break;
+
+        case FILTER_HIGH_PASS:
+            b0 = (1.0f + cosw0) * 0.5f;
+            b1 = -(1.0f + cosw0);
+            b2 = (1.0f + cosw0) * 0.5f;
+            a0 = 1.0f + alpha;
+            a1 = -2.0f * cosw0;
+            a2 = 1.0f - alpha;
+            break;
+
+        case FILTER_BAND_PASS:
+            b0 = alpha;
+            b1 = 0.0f;
+            b2 = -alpha;
+            a0 = 1.0f + alpha;
+            a1 = -2.0f * cosw0;
+            a2 = 1.0f - alpha;
+            break;
+
+        case FILTER_PEAKING:
+            b0 = 1.0f + alpha * A;
+            b1 = -2.0f * cosw0;
+            b2 = 1.0f - alpha * A;
+            a0 = 1.0f + alpha / A;
+            a1 = -2.0f * cosw0;
+            a2 = 1.0f - alpha / A;
+            break;
+
+        case FILTER_LOW_SHELF:
+        {
+            float sqrtA = sqrtf(A);
+            b0 =    A * ((A + 1.0f) - (A - 1.0f) * cosw0 + 2.0f * sqrtA * alpha);
+            b1 =  2.0f * A * ((A - 1.0f) - (A + 1.0f) * cosw0);
+            b2 =    A * ((A + 1.0f) - (A - 1.0f) * cosw0 - 2.0f * sqrtA * alpha);
+            a0 =        (A + 1.0f) + (A - 1.0f) * cosw0 + 2.0f * sqrtA * alpha;
+            a1 =   -2.0f * ((A - 1.0f) + (A + 1.0f) * cosw0);
+            a2 =        (A + 1.0f) + (A - 1.0f) * cosw0 - 2.0f * sqrtA * alpha;
+            break;
+        }
+
+        case FILTER_HIGH_SHELF:
+        {
+            float sqrtA = sqrtf(A);
+            b0 =    A * ((A + 1.0f) + (A - 1.0f) * cosw0 + 2.0f * sqrtA * alpha);
+            b1 = -2.0f * A * ((A - 1.0f) + (A + 1.0f) * cosw0);
+            b2 =    A * ((A + 1.0f) + (A - 1.0f) * cosw0 - 2.0f * sqrtA * alpha);
+            a0 =        (A + 1.0f) - (A - 1.0f) * cosw0 + 2.0f * sqrtA * alpha;
+            a1 =    2.0f * ((A - 1.0f) - (A + 1.0f) * cosw0);
+            a2 =        (A + 1.0f) - (A - 1.0f) * cosw0 - 2.0f * sqrtA * alpha;
+            break;
+        }
+        default:
+            return false;
+    }
+
+    const float eps = 1e-12f;
+    if (fabsf(a0) < eps) a0 = (a0 >= 0.0f) ? eps : -eps;
+
+    b0 /= a0;  b1 /= a0;  b2 /= a0;
+    a1 /= a0;  a2 /= a0;
+
+    if (!is_biquad_stable(a1, a2)) return false;
+
+    c->b0 = b0;
+    c->b1 = b1;
+    c->b2 = b2;
+    c->a1 = a1;
+    c->a2 = a2;
+    return true;
+}
@@ -0,0 +1,26 @@
+#ifndef BIQUAD_H
+#define BIQUAD_H
+
+#include <stdbool.h>
+
+typedef enum {
+    FILTER_LOW_PASS = 0,
+    FILTER_HIGH_PASS,
+    FILTER_BAND_PASS,
+    FILTER_PEAKING,
+    FILTER_LOW_SHELF,
+    FILTER_HIGH_SHELF
+} filter_type_t;
+
+// Normalized coefficients (a0 = 1)
+typedef struct {
+    float b0, b1, b2, a1, a2;
+} biquad_coeffs_t;
+
+// RBJ cookbook design. Plain C without ESP-IDF headers so host tools can
+// link it; false for an unknown type or an unstable result (c untouched).
+bool biquad_design(filter_type_t type, float fc, float Q, float gain_db, float fs,
+                   biquad_coeffs_t *c);
+bool is_biquad_stable(float a1, float a2);
+
+#endif // BIQUAD_H
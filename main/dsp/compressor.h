@@ -2,6 +2,7 @@
 #define COMPRESSOR_H
 
 #include <math.h>
+#include "dsp_math.h"
 
 typedef struct {
     float threshold;    
@@ -11,12 +12,56 @@ typedef struct {
     float release_coeff;
     float gain;       
     float knee_db;
+    float fs;
 } compressor_t;
 
 void compressor_init(compressor_t *c, float fs, float threshold, float ratio,
                      float makeup_db, float attack_ms, float release_ms, float knee);
 
+// Per sample, inline so the pipeline variants compile into one loop
+static inline float compressor_process(compressor_t *c, float x, float level)
+{
+    // dB via the inline log2 / exp2 of dsp_math.h: no libm call out of IRAM
+    float level_db = DSP_DB_PER_LOG2 * dsp_log2f((level > 1e-9f) ? level : 1e-9f);
+    float thr_db   = DSP_DB_PER_LOG2 * dsp_log2f((c->threshold > 1e-9f) ? c->threshold : 1e-9f);
+    float knee     = c->knee_db;
 
-float compressor_process(compressor_t *c, float x, float level);
+    float target_gain_db = 0.0f;
+
+    // Zone 1 : under the knee → no compression
+    if (level_db <= thr_db - (knee * 0.5f)) {
+        target_gain_db = 0.0f;
+    }
+
+    // Zone 2 : above the knee → standard compression 
+    else if (level_db >= thr_db + (knee * 0.5f)) {
+        float over_db = level_db - thr_db;
+        target_gain_db = (1.0f - 1.0f / c->ratio) * (-over_db);
+    }
+
+    // Zone 3 : inside the knee → soft compression 
+    else {
+        float delta = level_db - (thr_db - knee * 0.5f);
+        float soft = delta * delta / (2.0f * knee); 
+        target_gain_db = -(1.0f - 1.0f / c->ratio) * soft;
+    }
+
+    // linear gain
+    float target_gain = dsp_exp2f(target_gain_db * DSP_LOG2_PER_DB);
+
+    // Attack / Release smoothing
+    if (target_gain < c->gain)
+        c->gain = c->attack_coeff  * (c->gain - target_gain) + target_gain;
+    else
+        c->gain = c->release_coeff * (c->gain - target_gain) + target_gain;
+
+    // Apply gain and make-up
+    float y = x * c->gain * c->makeup;
+
+    // Hard clip
+    return (y > 1.0f) ? 1.0f : (y < -1.0f) ? -1.0f : y;
+}
+
+void  compressor_process_block(compressor_t *c, float *x, const float *level, int n);
 
 #endif // COMPRESSOR_H
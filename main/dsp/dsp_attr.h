@@ -0,0 +1,19 @@
+#ifndef DSP_ATTR_H
+#define DSP_ATTR_H
+
+// Memory placement of the audio hot path (CONFIG_AUDIO_HOT_IRAM).
+// Empty on the host and when the option is off.
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#include "esp_attr.h"
+#endif
+
+#if defined(ESP_PLATFORM) && CONFIG_AUDIO_HOT_IRAM
+#define DSP_HOT       IRAM_ATTR     // called every block on core 1
+#define DSP_RODATA    DRAM_ATTR     // const tables read by DSP_HOT code
+#else
+#define DSP_HOT
+#define DSP_RODATA
+#endif
+
+#endif // DSP_ATTR_H
@@ -0,0 +1,69 @@
+#ifndef DSP_KERNELS_H
+#define DSP_KERNELS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Block kernels shared by the pipeline, the meters and the FFT. One backend
+// is compiled in, chosen at build time:
+//   esp-dsp  CONFIG_AUDIO_KERNELS_ESPDSP (vector code on ESP32-S3)
+//   x86      host builds with SSE2, AVX2 paths when built with -mavx2
+//            (CONFIG_AUDIO_KERNELS_AVX2 on the linux target)
+//   scalar   CONFIG_AUDIO_KERNELS_SCALAR, -DDSP_KERNELS_SCALAR, anything else
+// The scalar versions stay available as dsp_ref_*() for cross-checking.
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+#if defined(CONFIG_AUDIO_KERNELS_ESPDSP)
+#define DSP_KERNELS_ESPDSP  1
+#elif defined(CONFIG_AUDIO_KERNELS_SCALAR) || defined(DSP_KERNELS_SCALAR) || !defined(__SSE2__)
+#define DSP_KERNELS_REF     1
+#else
+#define DSP_KERNELS_X86     1
+#endif
+
+// x[i] = dry[i] + (x[i] - dry[i]) * (mix + (i + 1) * step)
+void dsp_mix_ramp(float *x, const float *dry, int n, float mix, float step);
+
+// 24-bit left-justified I2S words → float, times scale
+void dsp_s24_to_f32(const int32_t *in, float *out, int n, float scale);
+
+// float → int16, saturated at +-1.0, truncated like a C cast
+void dsp_f32_to_s16(const float *in, int16_t *out, int n);
+
+// Windowed real input → interleaved complex (imaginary parts zero)
+void dsp_window_cplx(const float *x, const float *w, float *out, int n);
+
+// |X[k]|^2 of n interleaved complex bins
+void dsp_power_spectrum(const float *cplx, float *power, int n);
+
+float dsp_sum_sq(const float *x, int n);
+float dsp_max_abs(const float *x, int n);
+
+const char *dsp_kernels_backend(void);
+
+// Scalar reference
+void  dsp_ref_mix_ramp(float *x, const float *dry, int n, float mix, float step);
+void  dsp_ref_s24_to_f32(const int32_t *in, float *out, int n, float scale);
+void  dsp_ref_f32_to_s16(const float *in, int16_t *out, int n);
+void  dsp_ref_window_cplx(const float *x, const float *w, float *out, int n);
+void  dsp_ref_power_spectrum(const float *cplx, float *power, int n);
+float dsp_ref_sum_sq(const float *x, int n);
+float dsp_ref_max_abs(const float *x, int n);
+
+// Cross-check of the compiled backend against the reference on n-sample
+// blocks (plus odd lengths for the tails), then ns per call of both.
+// now_ns is the caller's clock; one line per kernel goes to report().
+typedef struct {
+    const char *name;
+    float max_err;          // worst relative error over the checked lengths
+    bool ok;
+    double ref_ns;
+    double backend_ns;
+} dsp_kernel_result_t;
+
+int dsp_kernels_check(int n, int iters, int64_t (*now_ns)(void),
+                      void (*report)(const dsp_kernel_result_t *r));
+
+#endif // DSP_KERNELS_H
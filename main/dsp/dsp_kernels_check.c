@@ -0,0 +1,156 @@
+#include "dsp_kernels.h"
+#include <math.h>
+#include <string.h>
+
+#define CHECK_MAX   1024
+
+// sum of squares is accumulated in a different order by the vector
+// backends; everything else should match the reference bit for bit
+#define TOL_EXACT   1e-6f
+#define TOL_SUM     1e-4f
+
+static float a[CHECK_MAX], b[CHECK_MAX], c[2 * CHECK_MAX];
+static float r_out[2 * CHECK_MAX], k_out[2 * CHECK_MAX];
+static int32_t s24[CHECK_MAX];
+static int16_t r16[CHECK_MAX], k16[CHECK_MAX];
+static volatile float sink;
+
+static uint32_t seed;
+
+static float rnd(void)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return (float)(seed >> 8) / 8388608.0f - 1.0f;
+}
+
+static void fill(void)
+{
+    seed = 12345;
+    for (int i = 0; i < CHECK_MAX; i++) {
+        a[i] = rnd() * 1.2f;        // some samples past full scale
+        b[i] = rnd();
+        seed = seed * 1664525u + 1013904223u;
+        s24[i] = (int32_t)seed;
+    }
+    for (int i = 0; i < 2 * CHECK_MAX; i++)
+        c[i] = rnd();
+}
+
+static float rel_err(float ref, float got)
+{
+    float d = fabsf(ref - got);
+    float m = fabsf(ref);
+    return (m > 1.0f) ? d / m : d;
+}
+
+static float cmp(const float *ref, const float *got, int n)
+{
+    float e = 0.0f;
+    for (int i = 0; i < n; i++)
+        e = fmaxf(e, rel_err(ref[i], got[i]));
+    return e;
+}
+
+static float cmp16(const int16_t *ref, const int16_t *got, int n)
+{
+    float e = 0.0f;
+    for (int i = 0; i < n; i++)
+        e = fmaxf(e, fabsf((float)ref[i] - (float)got[i]) / 32768.0f);
+    return e;
+}
+
+enum { K_MIX, K_S24, K_S16, K_WINDOW, K_POWER, K_SUMSQ, K_MAXABS, K_COUNT };
+
+static const char *const k_name[K_COUNT] = {
+    "mix_ramp", "s24_to_f32", "f32_to_s16", "window_cplx",
+    "power_spectrum", "sum_sq", "max_abs",
+};
+
+// One call of kernel k on n samples; ref picks the reference version.
+// Returns the error against the reference when check is set.
+static float run(int k, int n, bool ref, bool check)
+{
+    float e = 0.0f;
+    switch (k) {
+    case K_MIX:
+        if (check) {
+            memcpy(r_out, a, n * sizeof(float));
+            memcpy(k_out, a, n * sizeof(float));
+            dsp_ref_mix_ramp(r_out, b, n, 0.1f, 0.8f / n);
+            dsp_mix_ramp(k_out, b, n, 0.1f, 0.8f / n);
+            e = cmp(r_out, k_out, n);
+        } else if (ref) {
+            dsp_ref_mix_ramp(r_out, b, n, 0.1f, 0.8f / n);
+        } else {
+            dsp_mix_ramp(k_out, b, n, 0.1f, 0.8f / n);
+        }
+        break;
+    case K_S24:
+        if (ref || check) dsp_ref_s24_to_f32(s24, r_out, n, 1.0f / 8388608.0f);
+        if (!ref || check) dsp_s24_to_f32(s24, k_out, n, 1.0f / 8388608.0f);
+        if (check) e = cmp(r_out, k_out, n);
+        break;
+    case K_S16:
+        if (ref || check) dsp_ref_f32_to_s16(a, r16, n);
+        if (!ref || check) dsp_f32_to_s16(a, k16, n);
+        if (check) e = cmp16(r16, k16, n);
+        break;
+    case K_WINDOW:
+        if (ref || check) dsp_ref_window_cplx(a, b, r_out, n);
+        if (!ref || check) dsp_window_cplx(a, b, k_out, n);
+        if (check) e = cmp(r_out, k_out, 2 * n);
+        break;
+    case K_POWER:
+        if (ref || check) dsp_ref_power_spectrum(c, r_out, n);
+        if (!ref || check) dsp_power_spectrum(c, k_out, n);
+        if (check) e = cmp(r_out, k_out, n);
+        break;
+    case K_SUMSQ:
+        if (check)
+            e = rel_err(dsp_ref_sum_sq(a, n), dsp_sum_sq(a, n));
+        else
+            sink = ref ? dsp_ref_sum_sq(a, n) : dsp_sum_sq(a, n);
+        break;
+    case K_MAXABS:
+        if (check)
+            e = rel_err(dsp_ref_max_abs(a, n), dsp_max_abs(a, n));
+        else
+            sink = ref ? dsp_ref_max_abs(a, n) : dsp_max_abs(a, n);
+        break;
+    }
+    return e;
+}
+
+static double bench(int k, int n, int iters, bool ref, int64_t (*now_ns)(void))
+{
+    int64_t t0 = now_ns();
+    for (int i = 0; i < iters; i++)
+        run(k, n, ref, false);
+    return (double)(now_ns() - t0) / iters;
+}
+
+int dsp_kernels_check(int n, int iters, int64_t (*now_ns)(void),
+                      void (*report)(const dsp_kernel_result_t *r))
+{
+    static const int odd[] = { 1, 3, 5, 7, 9, 13, 17, 31, 33, 63 };
+    if (n < 1) n = 1;
+    if (n > CHECK_MAX) n = CHECK_MAX;
+    fill();
+
+    int failed = 0;
+    for (int k = 0; k < K_COUNT; k++) {
+        dsp_kernel_result_t r = { .name = k_name[k] };
+        r.max_err = run(k, n, false, true);
+        for (unsigned j = 0; j < sizeof(odd) / sizeof(odd[0]); j++)
+            r.max_err = fmaxf(r.max_err, run(k, odd[j], false, true));
+        r.ok = r.max_err <= ((k == K_SUMSQ) ? TOL_SUM : TOL_EXACT);
+        if (!r.ok) failed++;
+
+        if (iters > 0 && now_ns) {
+            r.ref_ns = bench(k, n, iters, true, now_ns);
+            r.backend_ns = bench(k, n, iters, false, now_ns);
+        }
+        if (report) report(&r);
+    }
+    return failed;
+}
@@ -0,0 +1,56 @@
+#include "dsp_kernels.h"
+
+#if DSP_KERNELS_ESPDSP
+
+#include <string.h>
+#include "esp_dsp.h"
+#include "dsp_attr.h"
+
+// esp-dsp picks its ae32 (ESP32) or aes3 (ESP32-S3 vector) implementation
+// itself. It has no ramp, integer conversion, |X|^2 or max-abs routine, those
+// call the reference kernels (an alias cannot cross translation units).
+
+DSP_HOT void dsp_mix_ramp(float *x, const float *dry, int n, float mix, float step)
+{
+    dsp_ref_mix_ramp(x, dry, n, mix, step);
+}
+
+DSP_HOT void dsp_s24_to_f32(const int32_t *in, float *out, int n, float scale)
+{
+    dsp_ref_s24_to_f32(in, out, n, scale);
+}
+
+DSP_HOT void dsp_f32_to_s16(const float *in, int16_t *out, int n)
+{
+    dsp_ref_f32_to_s16(in, out, n);
+}
+
+DSP_HOT void dsp_power_spectrum(const float *cplx, float *power, int n)
+{
+    dsp_ref_power_spectrum(cplx, power, n);
+}
+
+DSP_HOT float dsp_max_abs(const float *x, int n)
+{
+    return dsp_ref_max_abs(x, n);
+}
+
+DSP_HOT void dsp_window_cplx(const float *x, const float *w, float *out, int n)
+{
+    memset(out, 0, 2 * n * sizeof(float));
+    dsps_mul_f32(x, w, out, n, 1, 1, 2);        // real parts only
+}
+
+DSP_HOT float dsp_sum_sq(const float *x, int n)
+{
+    float acc = 0.0f;
+    dsps_dotprod_f32(x, x, &acc, n);
+    return acc;
+}
+
+const char *dsp_kernels_backend(void)
+{
+    return "esp-dsp";
+}
+
+#endif
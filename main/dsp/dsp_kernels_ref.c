@@ -0,0 +1,77 @@
+#include "dsp_kernels.h"
+#include "dsp_attr.h"
+#include <math.h>
+
+DSP_HOT void dsp_ref_mix_ramp(float *x, const float *dry, int n, float mix, float step)
+{
+    for (int i = 0; i < n; i++)
+        x[i] = dry[i] + (x[i] - dry[i]) * (mix + (float)(i + 1) * step);
+}
+
+DSP_HOT void dsp_ref_s24_to_f32(const int32_t *in, float *out, int n, float scale)
+{
+    for (int i = 0; i < n; i++)
+        out[i] = (float)(in[i] >> 8) * scale;
+}
+
+DSP_HOT void dsp_ref_f32_to_s16(const float *in, int16_t *out, int n)
+{
+    for (int i = 0; i < n; i++) {
+        float y = fminf(fmaxf(in[i], -1.0f), 1.0f);
+        out[i] = (int16_t)(y * 32767.0f);
+    }
+}
+
+DSP_HOT void dsp_ref_window_cplx(const float *x, const float *w, float *out, int n)
+{
+    for (int i = 0; i < n; i++) {
+        out[2 * i]     = x[i] * w[i];
+        out[2 * i + 1] = 0.0f;
+    }
+}
+
+DSP_HOT void dsp_ref_power_spectrum(const float *cplx, float *power, int n)
+{
+    for (int i = 0; i < n; i++)
+        power[i] = cplx[2 * i] * cplx[2 * i] + cplx[2 * i + 1] * cplx[2 * i + 1];
+}
+
+DSP_HOT float dsp_ref_sum_sq(const float *x, int n)
+{
+    float acc = 0.0f;
+    for (int i = 0; i < n; i++)
+        acc += x[i] * x[i];
+    return acc;
+}
+
+DSP_HOT float dsp_ref_max_abs(const float *x, int n)
+{
+    float m = 0.0f;
+    for (int i = 0; i < n; i++)
+        m = fmaxf(m, fabsf(x[i]));
+    return m;
+}
+
+#if DSP_KERNELS_REF
+
+void dsp_mix_ramp(float *x, const float *dry, int n, float mix, float step)
+    __attribute__((alias("dsp_ref_mix_ramp")));
+void dsp_s24_to_f32(const int32_t *in, float *out, int n, float scale)
+    __attribute__((alias("dsp_ref_s24_to_f32")));
+void dsp_f32_to_s16(const float *in, int16_t *out, int n)
+    __attribute__((alias("dsp_ref_f32_to_s16")));
+void dsp_window_cplx(const float *x, const float *w, float *out, int n)
+    __attribute__((alias("dsp_ref_window_cplx")));
+void dsp_power_spectrum(const float *cplx, float *power, int n)
+    __attribute__((alias("dsp_ref_power_spectrum")));
+float dsp_sum_sq(const float *x, int n)
+    __attribute__((alias("dsp_ref_sum_sq")));
+float dsp_max_abs(const float *x, int n)
+    __attribute__((alias("dsp_ref_max_abs")));
+
+const char *dsp_kernels_backend(void)
+{
+    return "scalar";
+}
+
+#endif
@@ -0,0 +1,172 @@
+#include "dsp_kernels.h"
+
+#if DSP_KERNELS_X86
+
+#include <immintrin.h>
+
+// SSE2 everywhere, 8-wide AVX2 where the compiler allows it (-mavx2).
+// Loops do whole vectors, the tails go to the reference kernels; every
+// lane does the same float operations as the reference, in the same order,
+// except the sum of squares which is accumulated per lane.
+
+void dsp_mix_ramp(float *x, const float *dry, int n, float mix, float step)
+{
+    int i = 0;
+#ifdef __AVX2__
+    const __m256 m8 = _mm256_set1_ps(mix), s8 = _mm256_set1_ps(step);
+    for (; i + 8 <= n; i += 8) {
+        __m256 idx = _mm256_cvtepi32_ps(_mm256_setr_epi32(i + 1, i + 2, i + 3, i + 4,
+                                                          i + 5, i + 6, i + 7, i + 8));
+        __m256 g = _mm256_add_ps(m8, _mm256_mul_ps(idx, s8));
+        __m256 d = _mm256_loadu_ps(dry + i);
+        __m256 v = _mm256_sub_ps(_mm256_loadu_ps(x + i), d);
+        _mm256_storeu_ps(x + i, _mm256_add_ps(d, _mm256_mul_ps(v, g)));
+    }
+#endif
+    const __m128 m4 = _mm_set1_ps(mix), s4 = _mm_set1_ps(step);
+    for (; i + 4 <= n; i += 4) {
+        __m128 idx = _mm_cvtepi32_ps(_mm_setr_epi32(i + 1, i + 2, i + 3, i + 4));
+        __m128 g = _mm_add_ps(m4, _mm_mul_ps(idx, s4));
+        __m128 d = _mm_loadu_ps(dry + i);
+        __m128 v = _mm_sub_ps(_mm_loadu_ps(x + i), d);
+        _mm_storeu_ps(x + i, _mm_add_ps(d, _mm_mul_ps(v, g)));
+    }
+    for (; i < n; i++)
+        x[i] = dry[i] + (x[i] - dry[i]) * (mix + (float)(i + 1) * step);
+}
+
+void dsp_s24_to_f32(const int32_t *in, float *out, int n, float scale)
+{
+    int i = 0;
+#ifdef __AVX2__
+    const __m256 k8 = _mm256_set1_ps(scale);
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_srai_epi32(_mm256_loadu_si256((const __m256i *)(in + i)), 8);
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), k8));
+    }
+#endif
+    const __m128 k4 = _mm_set1_ps(scale);
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(in + i)), 8);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(v), k4));
+    }
+    dsp_ref_s24_to_f32(in + i, out + i, n - i, scale);
+}
+
+void dsp_f32_to_s16(const float *in, int16_t *out, int n)
+{
+    const __m128 lo = _mm_set1_ps(-1.0f), hi = _mm_set1_ps(1.0f), k = _mm_set1_ps(32767.0f);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), lo), hi);
+        __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4), lo), hi);
+        __m128i ia = _mm_cvttps_epi32(_mm_mul_ps(a, k));
+        __m128i ib = _mm_cvttps_epi32(_mm_mul_ps(b, k));
+        _mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(ia, ib));
+    }
+    dsp_ref_f32_to_s16(in + i, out + i, n - i);
+}
+
+void dsp_window_cplx(const float *x, const float *w, float *out, int n)
+{
+    const __m128 zero = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 p = _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(w + i));
+        _mm_storeu_ps(out + 2 * i,     _mm_unpacklo_ps(p, zero));
+        _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(p, zero));
+    }
+    dsp_ref_window_cplx(x + i, w + i, out + 2 * i, n - i);
+}
+
+void dsp_power_spectrum(const float *cplx, float *power, int n)
+{
+    int i = 0;
+#ifdef __AVX2__
+    for (; i + 8 <= n; i += 8) {
+        __m256 a = _mm256_loadu_ps(cplx + 2 * i);
+        __m256 b = _mm256_loadu_ps(cplx + 2 * i + 8);
+        a = _mm256_mul_ps(a, a);
+        b = _mm256_mul_ps(b, b);
+        __m256 re = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 im = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        // shuffles work per 128-bit lane: bins come out as 0 1 4 5 | 2 3 6 7
+        __m256 p = _mm256_add_ps(re, im);
+        p = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(p), _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_ps(power + i, p);
+    }
+#endif
+    for (; i + 4 <= n; i += 4) {
+        __m128 a = _mm_loadu_ps(cplx + 2 * i);
+        __m128 b = _mm_loadu_ps(cplx + 2 * i + 4);
+        a = _mm_mul_ps(a, a);
+        b = _mm_mul_ps(b, b);
+        __m128 re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(power + i, _mm_add_ps(re, im));
+    }
+    dsp_ref_power_spectrum(cplx + 2 * i, power + i, n - i);
+}
+
+static inline float hsum4(__m128 v)
+{
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+static inline float hmax4(__m128 v)
+{
+    v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_max_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+float dsp_sum_sq(const float *x, int n)
+{
+    __m128 acc = _mm_setzero_ps();
+    int i = 0;
+#ifdef __AVX2__
+    __m256 acc8 = _mm256_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(x + i);
+        acc8 = _mm256_add_ps(acc8, _mm256_mul_ps(v, v));
+    }
+    acc = _mm_add_ps(_mm256_castps256_ps128(acc8), _mm256_extractf128_ps(acc8, 1));
+#endif
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(x + i);
+        acc = _mm_add_ps(acc, _mm_mul_ps(v, v));
+    }
+    return hsum4(acc) + dsp_ref_sum_sq(x + i, n - i);
+}
+
+float dsp_max_abs(const float *x, int n)
+{
+    const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 m = _mm_setzero_ps();
+    int i = 0;
+#ifdef __AVX2__
+    const __m256 mask8 = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 m8 = _mm256_setzero_ps();
+    for (; i + 8 <= n; i += 8)
+        m8 = _mm256_max_ps(m8, _mm256_and_ps(_mm256_loadu_ps(x + i), mask8));
+    m = _mm_max_ps(_mm256_castps256_ps128(m8), _mm256_extractf128_ps(m8, 1));
+#endif
+    for (; i + 4 <= n; i += 4)
+        m = _mm_max_ps(m, _mm_and_ps(_mm_loadu_ps(x + i), mask));
+    float tail = dsp_ref_max_abs(x + i, n - i);
+    float v = hmax4(m);
+    return (tail > v) ? tail : v;
+}
+
+const char *dsp_kernels_backend(void)
+{
+#ifdef __AVX2__
+    return "avx2";
+#else
+    return "sse2";
+#endif
+}
+
+#endif
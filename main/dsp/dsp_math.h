@@ -0,0 +1,80 @@
+#ifndef DSP_MATH_H
+#define DSP_MATH_H
+
+#include <stdint.h>
+
+// log2 / exp2 for the per-sample gain computers. libm's log10f / powf /
+// expf / tanhf live in flash, so a DSP_HOT caller would still stall on a
+// cache miss; these inline into the caller and stay in IRAM with it.
+// Accurate to a few float ulp, no errno, no special cases beyond what the
+// callers need (finite input, x > 0 for the logarithm).
+
+#define DSP_DB_PER_LOG2   6.02059991f     // 20 * log10(2)
+#define DSP_LOG2_PER_DB   0.166096405f    // log2(10) / 20
+
+typedef union { float f; uint32_t u; } dsp_f32_bits_t;
+
+// x > 0; denormals read as 2^-127
+static inline float dsp_log2f(float x)
+{
+    dsp_f32_bits_t v = { .f = x };
+    int e = (int)((v.u >> 23) & 0xFF) - 127;
+    v.u = (v.u & 0x007FFFFFu) | 0x3F800000u;    // mantissa in [1, 2)
+    float m = v.f;
+    if (m > 1.41421356f) { m *= 0.5f; e++; }
+
+    // log2(m) = 2/ln2 * atanh(t), t = (m-1)/(m+1) in [-0.172, 0.172]
+    float t = (m - 1.0f) / (m + 1.0f), t2 = t * t;
+    float p = 0.320598898f;
+    p = p * t2 + 0.412198583f;
+    p = p * t2 + 0.577078016f;
+    p = p * t2 + 0.961796694f;
+    p = p * t2 + 2.88539008f;
+    return (float)e + t * p;
+}
+
+// 0 below 2^-126, saturates at 2^128
+static inline float dsp_exp2f(float x)
+{
+    if (x < -126.0f) return 0.0f;
+    if (x > 127.999f) x = 127.999f;
+
+    int i = (int)x;
+    if ((float)i > x) i--;                      // floor, also for negatives
+    float y = (x - (float)i - 0.5f) * 0.693147181f;    // |y| <= ln2/2
+
+    // e^y, Taylor to y^7, times sqrt(2) for the half shifted out above
+    float p = 1.0f / 5040.0f;
+    p = p * y + 1.0f / 720.0f;
+    p = p * y + 1.0f / 120.0f;
+    p = p * y + 1.0f / 24.0f;
+    p = p * y + 1.0f / 6.0f;
+    p = p * y + 0.5f;
+    p = p * y + 1.0f;
+    p = p * y + 1.0f;
+
+    dsp_f32_bits_t s = { .u = (uint32_t)(i + 127) << 23 };
+    return 1.41421356f * p * s.f;
+}
+
+// fminf / fmaxf are library calls on the target
+static inline float dsp_clampf(float x, float lo, float hi)
+{
+    return (x < lo) ? lo : (x > hi) ? hi : x;
+}
+
+// x^y for x > 0
+static inline float dsp_powf(float x, float y)
+{
+    return dsp_exp2f(y * dsp_log2f(x));
+}
+
+// tanh(x) = 1 - 2 / (e^2x + 1), odd-symmetric so small |x| keeps its sign
+static inline float dsp_tanhf(float x)
+{
+    float a = (x < 0.0f) ? -x : x;
+    float r = 1.0f - 2.0f / (dsp_exp2f(2.88539008f * a) + 1.0f);
+    return (x < 0.0f) ? -r : r;
+}
+
+#endif // DSP_MATH_H
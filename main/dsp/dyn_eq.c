@@ -0,0 +1,152 @@
+#include "dyn_eq.h"
+#include "dsp_attr.h"
+#include "dsp_math.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void dyn_eq_init(dyn_eq_t *d, float fs)
+{
+    if (!d) return;
+    memset(d, 0, sizeof(*d));
+    d->fs = fs;
+    d->attack_ms = 1.0f;
+    d->release_ms = 60.0f;
+
+    for (int k = 0; k < DYN_EQ_BANDS; k++) {
+        dyn_eq_band_t *b = &d->band[k];
+        b->fc = DYN_EQ_DEESS_FC;
+        b->Q = DYN_EQ_DEESS_Q;
+        b->threshold_db = -30.0f;
+        b->ratio = 4.0f;
+        b->range_db = 10.0f;
+        b->cur.b0 = 1.0f;       // unity until the first control step
+    }
+    dyn_eq_update(d);
+}
+
+void dyn_eq_update(dyn_eq_t *d)
+{
+    float steps = d->fs / DYN_EQ_CTRL;
+    d->att_coeff = expf(-1.0f / (steps * fmaxf(d->attack_ms, 0.01f) * 0.001f));
+    d->rel_coeff = expf(-1.0f / (steps * fmaxf(d->release_ms, 0.01f) * 0.001f));
+
+    for (int k = 0; k < DYN_EQ_BANDS; k++) {
+        dyn_eq_band_t *b = &d->band[k];
+        float fc = fminf(b->fc, 0.45f * d->fs);
+        if (fc != b->design_fc || b->Q != b->design_Q || d->fs != b->design_fs) {
+            float w0 = 2.0f * (float)M_PI * fc / d->fs;
+            b->cosw0 = cosf(w0);
+            b->alpha = sinf(w0) / (2.0f * b->Q);
+
+            biquad_coeffs_t sc;
+            if (biquad_design(FILTER_BAND_PASS, fc, b->Q, 0.0f, d->fs, &sc)) b->sc = sc;
+            b->sc_w1 = b->sc_w2 = 0.0f;     // the envelope carries on
+            b->design_fc = fc;
+            b->design_Q = b->Q;
+            b->design_fs = d->fs;
+        }
+
+        if (b->enabled && !b->applied) {
+            if (!b->fading) {
+                // nothing from the last run: unity, empty filters, no level
+                memset(&b->cur, 0, sizeof(b->cur));
+                b->cur.b0 = 1.0f;
+                b->sc_w1 = b->sc_w2 = b->w1 = b->w2 = 0.0f;
+                b->env = 0.0f;
+                b->gain_db = 0.0f;
+            }
+            b->fading = false;
+        }
+        else if (!b->enabled && b->applied) {
+            b->fading = b->gain_db < 0.0f;
+        }
+        b->applied = b->enabled;
+    }
+}
+
+// RBJ peaking with the cached cos/alpha: no trig at control rate
+static inline void peaking_coeffs(const dyn_eq_band_t *b, float gain_db, biquad_coeffs_t *c)
+{
+    float A = dsp_exp2f(gain_db * (0.5f * DSP_LOG2_PER_DB));
+    float inv_a0 = 1.0f / (1.0f + b->alpha / A);
+    c->b0 = (1.0f + b->alpha * A) * inv_a0;
+    c->b1 = -2.0f * b->cosw0 * inv_a0;
+    c->b2 = (1.0f - b->alpha * A) * inv_a0;
+    c->a1 = c->b1;
+    c->a2 = (1.0f - b->alpha / A) * inv_a0;
+}
+
+// Sidechain over one control step, then the new cut
+static DSP_HOT void band_control(dyn_eq_t *d, dyn_eq_band_t *b, const float *x, int n)
+{
+    const biquad_coeffs_t *s = &b->sc;
+    float w1 = b->sc_w1, w2 = b->sc_w2, acc = 0.0f;
+    for (int i = 0; i < n; i++) {
+        float y = s->b0 * x[i] + w1;
+        w1 = s->b1 * x[i] - s->a1 * y + w2;
+        w2 = s->b2 * x[i] - s->a2 * y;
+        acc += y * y;
+    }
+    b->sc_w1 = w1;
+    b->sc_w2 = w2;
+
+    float ms = acc / (float)n;
+    float c = (ms > b->env) ? d->att_coeff : d->rel_coeff;
+    b->env = c * (b->env - ms) + ms;
+
+    float over = 0.5f * DSP_DB_PER_LOG2 * dsp_log2f(b->env + 1e-12f) - b->threshold_db;
+    float cut = (over > 0.0f) ? over * (1.0f - 1.0f / b->ratio) : 0.0f;
+    b->gain_db = (cut < b->range_db) ? -cut : -b->range_db;
+}
+
+// Peaking biquad, coefficients ramped linearly to the new target across
+// the step (the stability triangle is convex, so every step stays stable)
+static DSP_HOT void band_filter(dyn_eq_band_t *b, float *x, int n)
+{
+    biquad_coeffs_t t, c = b->cur;
+    peaking_coeffs(b, b->gain_db, &t);
+
+    float k = 1.0f / (float)n;
+    float db0 = (t.b0 - c.b0) * k, db1 = (t.b1 - c.b1) * k, db2 = (t.b2 - c.b2) * k;
+    float da1 = (t.a1 - c.a1) * k, da2 = (t.a2 - c.a2) * k;
+    float w1 = b->w1, w2 = b->w2;
+
+    for (int i = 0; i < n; i++) {
+        c.b0 += db0; c.b1 += db1; c.b2 += db2; c.a1 += da1; c.a2 += da2;
+        float y = c.b0 * x[i] + w1;
+        w1 = c.b1 * x[i] - c.a1 * y + w2;
+        w2 = c.b2 * x[i] - c.a2 * y;
+        x[i] = y;
+    }
+
+    b->cur = t;
+    b->w1 = w1;
+    b->w2 = w2;
+}
+
+DSP_HOT void dyn_eq_process_block(dyn_eq_t *d, float *x, int n)
+{
+    for (int off = 0; off < n; off += DYN_EQ_CTRL) {
+        int m = (n - off < DYN_EQ_CTRL) ? n - off : DYN_EQ_CTRL;
+        for (int k = 0; k < DYN_EQ_BANDS; k++) {
+            dyn_eq_band_t *b = &d->band[k];
+            if (b->enabled) {
+                band_control(d, b, x + off, m);     // feed-forward: detect on the input
+            }
+            else if (b->fading) {
+                // release to 0 dB; the last step lands on the identity filter
+                b->gain_db *= d->rel_coeff;
+                if (b->gain_db > -0.01f) {
+                    b->gain_db = 0.0f;
+                    b->fading = false;
+                }
+            }
+            else continue;
+            band_filter(b, x + off, m);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef DYN_EQ_H
+#define DYN_EQ_H
+
+#include <stdbool.h>
+#include "biquad.h"
+
+#define DYN_EQ_BANDS     2
+#define DYN_EQ_CTRL      16     // samples per control step (gain + coefficients)
+
+// De-esser: 5-9 kHz, geometric centre and Q = fc / bandwidth
+#define DYN_EQ_DEESS_FC  6700.0f
+#define DYN_EQ_DEESS_Q   1.7f
+
+// Peaking band whose cut follows a bandpass sidechain of the input
+typedef struct {
+    bool  enabled;
+    float fc;
+    float Q;
+    float threshold_db;     // sidechain level where the cut starts
+    float ratio;
+    float range_db;         // deepest cut, positive
+
+    // derived (dyn_eq_update)
+    biquad_coeffs_t sc;     // sidechain bandpass
+    float cosw0, alpha;     // peaking design, only A changes at control rate
+    float design_fc, design_Q, design_fs;   // what the two above were built for
+    bool  applied;          // `enabled` as of the last update
+
+    // state
+    float sc_w1, sc_w2;
+    biquad_coeffs_t cur;    // peaking coefficients, ramped per sample
+    float w1, w2;
+    float env;              // sidechain mean square
+    float gain_db;          // current cut, <= 0
+    bool  fading;           // disabled, cut still releasing to 0 dB
+} dyn_eq_band_t;
+
+typedef struct {
+    dyn_eq_band_t band[DYN_EQ_BANDS];
+    float attack_ms;
+    float release_ms;
+    float fs;
+    float att_coeff, rel_coeff;     // per control step
+} dyn_eq_t;
+
+void dyn_eq_init(dyn_eq_t *d, float fs);
+
+// Re-derives filters and time constants from the user fields (fs included).
+// Only a band whose fc / Q / fs changed restarts its sidechain filter; a
+// disabled band releases its cut, a re-enabled one starts from unity.
+void dyn_eq_update(dyn_eq_t *d);
+
+void dyn_eq_process_block(dyn_eq_t *d, float *x, int n);
+
+#endif // DYN_EQ_H
@@ -1,10 +1,11 @@
 #include "expander.h"
-#include "config.h"
+#include "dsp_attr.h"
 
 void expander_init(expander_t *e, float fs, float threshold, float ratio,
                    float attack_ms, float release_ms, float hold_ms)
 {
     if (!e) return;
+    e->fs = fs;
     e->threshold = threshold;
     e->ratio = (ratio < 1.0f) ? 1.0f : ratio;
     e->attack_coeff  = expf(-1.0f / (fs * (attack_ms * 0.001f)));
@@ -12,34 +13,21 @@ void expander_init(expander_t *e, float fs, float threshold, float ratio,
     e->hold_time = hold_ms / 1000.0f;
     e->hold_counter = 0.0f;
     e->gain = 1.0f;
+    e->key_enabled = false;
+    e->key_open = true;
+    e->key_floor = 0.1f;
 }
 
-float expander_process(expander_t *e, float x, float level)
+void expander_set_key(expander_t *e, bool enabled, float floor_db)
 {
-    float target_gain = 1.0f;
-
-    // target gain
-    if (level < e->threshold) {
-       
-        float under = e->threshold / fmaxf(level, 1e-9f);
-        target_gain = powf(under, (1.0f / e->ratio) - 1.0f); 
-        e->hold_counter = 0.0f; 
-    } else {
-        
-        if (e->hold_counter < e->hold_time)
-            e->hold_counter += 1.0f / I2S_SR; 
-        else
-            target_gain = 1.0f; 
-    }
-
-    // Attack / Release smoothing
-    if (target_gain < e->gain)
-        e->gain = e->attack_coeff  * (e->gain - target_gain) + target_gain;
-    else
-        e->gain = e->release_coeff * (e->gain - target_gain) + target_gain;
-
-   
-    float y = x * e->gain;
+    if (!e) return;
+    e->key_floor = powf(10.0f, fminf(floor_db, 0.0f) / 20.0f);
+    e->key_open = true;
+    e->key_enabled = enabled;
+}
 
-    return y;
+DSP_HOT void expander_process_block(expander_t *e, float *x, const float *level, int n)
+{
+    for (int i = 0; i < n; i++)
+        x[i] = expander_process(e, x[i], level[i]);
 }
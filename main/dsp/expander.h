@@ -2,6 +2,8 @@
 #define EXPANDER_H
 
 #include <math.h>
+#include <stdbool.h>
+#include "dsp_math.h"
 
 typedef struct {
     float threshold;    
@@ -11,11 +13,58 @@ typedef struct {
     float hold_time;     
     float hold_counter;  
     float gain;          
+    bool  key_enabled;   // sidechain key (VAD) replaces the threshold decision
+    volatile bool key_open;
+    float key_floor;     // max gain while the key is closed
+    float fs;
 } expander_t;
 
-void fft_init(expander_t *e, float fs, float threshold, float ratio,
+void expander_init(expander_t *e, float fs, float threshold, float ratio,
                    float attack_ms, float release_ms, float hold_ms);
 
-float expander_process(expander_t *e, float x, float level);
+// Per sample, inline so the pipeline variants compile into one loop
+static inline float expander_process(expander_t *e, float x, float level)
+{
+    float target_gain = 1.0f;
+
+    // keyed: the sidechain decides, level only shapes the closed gain
+    if (e->key_enabled) {
+        if (!e->key_open) {
+            float under = e->threshold / ((level > 1e-9f) ? level : 1e-9f);
+            target_gain = dsp_powf(under, (1.0f / e->ratio) - 1.0f);
+            if (target_gain > e->key_floor) target_gain = e->key_floor;
+        }
+    }
+
+    // target gain
+    else if (level < e->threshold) {
+       
+        float under = e->threshold / ((level > 1e-9f) ? level : 1e-9f);
+        target_gain = dsp_powf(under, (1.0f / e->ratio) - 1.0f);
+        e->hold_counter = 0.0f; 
+    } else {
+        
+        if (e->hold_counter < e->hold_time)
+            e->hold_counter += 1.0f / e->fs;
+        else
+            target_gain = 1.0f; 
+    }
+
+    // Attack / Release smoothing
+    if (target_gain < e->gain)
+        e->gain = e->attack_coeff  * (e->gain - target_gain) + target_gain;
+    else
+        e->gain = e->release_coeff * (e->gain - target_gain) + target_gain;
+
+   
+    float y = x * e->gain;
+
+    return y;
+}
+
+void  expander_process_block(expander_t *e, float *x, const float *level, int n);
+
+// Sidechain key: when enabled, the gate opens on key_open instead of level
+void expander_set_key(expander_t *e, bool enabled, float floor_db);
 
 #endif // EXPANDER_H
@@ -1,10 +1,11 @@
 #include "esp_dsp.h"
-#include "uart_interface.h"
 #include <math.h>
 
 #define FFT_SIZE 512
 
 extern float fft_last_bands[8];
 
-void fft_init(void);
-void analyze_fft_and_send(const float *samples);
\ No newline at end of file
+esp_err_t fft_init(float fs);
+void fft_set_sample_rate(float fs);
+void analyze_fft_and_send(const float *samples);    // into fft_last_bands
+void fft_bands(const float *samples, float *bands_db);   // same, into bands_db[8]
\ No newline at end of file
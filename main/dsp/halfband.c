@@ -0,0 +1,55 @@
+#include "halfband.h"
+#include <math.h>
+#include <string.h>
+
+#define HB_HALF   ((HALFBAND_TAPS - 1) / 2)     // 15
+#define HB_PAIRS  ((HB_HALF + 1) / 2)           // non-zero side taps: ±1, ±3, ... ±15
+
+static float hb_coeff[HB_PAIRS];                // h[center ± (2k+1)]
+
+void halfband_design(void)
+{
+    // Blackman-windowed sinc, cutoff fs/4
+    float sum = 0.5f;
+    for (int k = 0; k < HB_PAIRS; k++) {
+        int n = 2 * k + 1;
+        float x = (float)M_PI * n * 0.5f;
+        float sinc = sinf(x) / x;
+        float w = 0.42f + 0.5f * cosf((float)M_PI * n / (HB_HALF + 1))
+                        + 0.08f * cosf(2.0f * (float)M_PI * n / (HB_HALF + 1));
+        hb_coeff[k] = 0.5f * sinc * w;
+        sum += 2.0f * hb_coeff[k];
+    }
+    // normalise DC gain to 1, keeping the 0.5 centre tap
+    float scale = 0.5f / (sum - 0.5f);
+    for (int k = 0; k < HB_PAIRS; k++) hb_coeff[k] *= scale;
+}
+
+void halfband_reset(halfband_t *h)
+{
+    memset(h->hist, 0, sizeof(h->hist));
+}
+
+int halfband_decimate(halfband_t *h, const float *in, int n, float *out)
+{
+    float buf[HALFBAND_TAPS - 1 + HALFBAND_MAX_BLOCK];
+
+    if (n > HALFBAND_MAX_BLOCK) n = HALFBAND_MAX_BLOCK;
+    n &= ~1;
+
+    memcpy(buf, h->hist, sizeof(h->hist));
+    memcpy(&buf[HALFBAND_TAPS - 1], in, n * sizeof(float));
+
+    for (int m = 0; m < n / 2; m++) {
+        const float *c = &buf[2 * m + 1 + HB_HALF];     // centre tap
+        float acc = 0.5f * c[0];
+        for (int k = 0; k < HB_PAIRS; k++) {
+            int d = 2 * k + 1;
+            acc += hb_coeff[k] * (c[-d] + c[d]);
+        }
+        out[m] = acc;
+    }
+
+    memcpy(h->hist, &buf[n], sizeof(h->hist));
+    return n / 2;
+}
@@ -0,0 +1,18 @@
+#ifndef HALFBAND_H
+#define HALFBAND_H
+
+#define HALFBAND_TAPS       31      // 4k+3, every other tap is zero
+#define HALFBAND_MAX_BLOCK  128     // input samples per call
+
+typedef struct {
+    float hist[HALFBAND_TAPS - 1];
+} halfband_t;
+
+// Shared coefficients, computed once (windowed sinc, unity DC gain)
+void halfband_design(void);
+void halfband_reset(halfband_t *h);
+
+// Decimate by 2: n input samples (even, <= HALFBAND_MAX_BLOCK) → n/2 outputs
+int  halfband_decimate(halfband_t *h, const float *in, int n, float *out);
+
+#endif // HALFBAND_H
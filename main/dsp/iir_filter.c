@@ -1,7 +1,13 @@
 #include "iir_filter.h"
+#include "dsp_attr.h"
+#ifdef ESP_PLATFORM
 #include "esp_log.h"
+#else
+// host tools (tools/pipeline_bench.c)
+#define ESP_LOGW(tag, fmt, ...)  fprintf(stderr, "%s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI                 ESP_LOGW
+#endif
 #include <math.h>
-#include "config.h"
 
 static const char *TAG_FILT = "FILTER";
 
@@ -13,22 +19,16 @@ const char* filter_type_to_str(filter_type_t type)
         case FILTER_LOW_PASS:  return "Low-Pass";
         case FILTER_HIGH_PASS: return "High-Pass";
         case FILTER_BAND_PASS: return "Band-Pass";
+        case FILTER_PEAKING:   return "Peaking";
+        case FILTER_LOW_SHELF: return "Low-Shelf";
+        case FILTER_HIGH_SHELF:return "High-Shelf";
         default:               return "Unknown";
     }
 }
 
-bool is_biquad_stable(float a1, float a2)
-{
-    
-    if (fabsf(a2) >= 1.0f) return false;
-    if (a1 <= -1.0f - a2) return false;
-    if (a1 >= 1.0f - a2) return false;
-    return true;
-}
-
 void update_filter_coefficients_eq(eq_band_t *band)
 {
-    float fs = (float)I2S_SR;
+    float fs = band->fs;
     if (band->fc < 20.0f)         band->fc = 20.0f;
     if (band->fc > 0.45f * fs)    band->fc = 0.45f * fs;
     if (band->Q  < 0.3f)          band->Q  = 0.3f;
@@ -36,95 +36,17 @@ void update_filter_coefficients_eq(eq_band_t *band)
     if (band->gain_db > 8.0f) band->gain_db = 8.0f;
     if (band->gain_db < -8.0f) band->gain_db = -8.0f;
 
-    float a0 = 1.0f, a1 = 0.0f, a2 = 0.0f;
-    float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
-
-    const float w0    = 2.0f * (float)M_PI * band->fc / fs;
-    const float cosw0 = cosf(w0);
-    const float sinw0 = sinf(w0);
-    const float alpha = sinw0 / (2.0f * band->Q);
-    const float A     = powf(10.0f, band->gain_db / 40.0f);  // linéaire
-    
-    switch (band->type) {
-        case FILTER_LOW_PASS:
-            b0 = (1.0f - cosw0) * 0.5f;
-            b1 = 1.0f - cosw0;
-            b2 = (1.0f - cosw0) * 0.5f;
-            a0 = 1.0f + alpha;
-            a1 = -2.0f * cosw0;
-            a2 = 1.0f - alpha;
-            break;
-
-        case FILTER_HIGH_PASS:
-            b0 = (1.0f + cosw0) * 0.5f;
-            b1 = -(1.0f + cosw0);
-            b2 = (1.0f + cosw0) * 0.5f;
-            a0 = 1.0f + alpha;
-            a1 = -2.0f * cosw0;
-            a2 = 1.0f - alpha;
-            break;
-
-        case FILTER_BAND_PASS:
-            b0 = alpha;
-            b1 = 0.0f;
-            b2 = -alpha;
-            a0 = 1.0f + alpha;
-            a1 = -2.0f * cosw0;
-            a2 = 1.0f - alpha;
-            break;
-
-        case FILTER_PEAKING:
-            b0 = 1.0f + alpha * A;
-            b1 = -2.0f * cosw0;
-            b2 = 1.0f - alpha * A;
-            a0 = 1.0f + alpha / A;
-            a1 = -2.0f * cosw0;
-            a2 = 1.0f - alpha / A;
-            break;
-
-        case FILTER_LOW_SHELF:
-        {
-            float sqrtA = sqrtf(A);
-            b0 =    A * ((A + 1.0f) - (A - 1.0f) * cosw0 + 2.0f * sqrtA * alpha);
-            b1 =  2.0f * A * ((A - 1.0f) - (A + 1.0f) * cosw0);
-            b2 =    A * ((A + 1.0f) - (A - 1.0f) * cosw0 - 2.0f * sqrtA * alpha);
-            a0 =        (A + 1.0f) + (A - 1.0f) * cosw0 + 2.0f * sqrtA * alpha;
-            a1 =   -2.0f * ((A - 1.0f) + (A + 1.0f) * cosw0);
-            a2 =        (A + 1.0f) + (A - 1.0f) * cosw0 - 2.0f * sqrtA * alpha;
-            break;
-        }
-
-        case FILTER_HIGH_SHELF:
-        {
-            float sqrtA = sqrtf(A);
-            b0 =    A * ((A + 1.0f) + (A - 1.0f) * cosw0 + 2.0f * sqrtA * alpha);
-            b1 = -2.0f * A * ((A - 1.0f) + (A + 1.0f) * cosw0);
-            b2 =    A * ((A + 1.0f) + (A - 1.0f) * cosw0 - 2.0f * sqrtA * alpha);
-            a0 =        (A + 1.0f) - (A - 1.0f) * cosw0 + 2.0f * sqrtA * alpha;
-            a1 =    2.0f * ((A - 1.0f) - (A + 1.0f) * cosw0);
-            a2 =        (A + 1.0f) - (A - 1.0f) * cosw0 - 2.0f * sqrtA * alpha;
-            break;
-        }
-        default:
-            return;
-    }
-
-    const float eps = 1e-12f;
-    if (fabsf(a0) < eps) a0 = (a0 >= 0.0f) ? eps : -eps;
-
-    b0 /= a0;  b1 /= a0;  b2 /= a0;
-    a1 /= a0;  a2 /= a0;
-
-    if (!is_biquad_stable(a1, a2)) {
-        ESP_LOGW(TAG, "Unstable filter rejected! fc=%.1fHz Q=%.2f a1=%.3f a2=%.3f",band->fc, band->Q, a1, a2);
+    biquad_coeffs_t c;
+    if (!biquad_design(band->type, band->fc, band->Q, band->gain_db, fs, &c)) {
+        ESP_LOGW(TAG_FILT, "Unstable filter rejected! fc=%.1fHz Q=%.2f", band->fc, band->Q);
         return;
     }
 
-    band->b0 = b0;  
-    band->b1 = b1;  
-    band->b2 = b2;
-    band->a1 = a1;  
-    band->a2 = a2;
+    band->b0 = c.b0;  
+    band->b1 = c.b1;  
+    band->b2 = c.b2;
+    band->a1 = c.a1;  
+    band->a2 = c.a2;
 
     band->w1 = 0.0f; 
     band->w2 = 0.0f;
@@ -145,6 +67,11 @@ const eq_band_t* eq_get_band(eq_band_id_t id)
     return band_ptr(id);
 }
 
+eq3band_t *eq_state(void)
+{
+    return &eq;
+}
+
 void eq_get_all_bands(const eq_band_t **low,
                       const eq_band_t **mid,
                       const eq_band_t **high)
@@ -154,22 +81,10 @@ void eq_get_all_bands(const eq_band_t **low,
     if (high) *high = &eq.high;
 }
 
-void print_filter_status(void)
+void eq_init(float fs)
 {
-    ESP_LOGI(TAG_FILT,
-        "Current filter:\n"
-        "  b0=%.7f\n"
-        "  b1=%.7f\n"
-        "  b2=%.7f\n"
-        "  a1=%.7f\n"
-        "  a2=%.7f\n"
-        "  filter type : %s\n"
-        "  Q = %.3f\n",
-        filt.b0, filt.b1, filt.b2, filt.a1, filt.a2, filter_type_to_str(filt.type), filt.q);
-}
+    eq.low.fs = eq.mid.fs = eq.high.fs = fs;
 
-void eq_init(void)
-{
     eq.low.type = FILTER_LOW_SHELF;
     eq.low.fc = 100.0f;
     eq.low.Q = 0.707f;
@@ -190,23 +105,18 @@ void eq_init(void)
     update_filter_coefficients_eq(&eq.high);
 }
 
-float biquad_df2t_process_eq(eq_band_t *b, float x)
+void eq_set_sample_rate(float fs)
 {
-    float y = b->b0 * x + b->w1;
-    float w1_next = b->b1 * x + b->w2 - b->a1 * y;
-    float w2_next = b->b2 * x - b->a2 * y;
-
-    b->w1 = w1_next;
-    b->w2 = w2_next;
-
-    return y;
+    eq_band_t *bands[3] = { &eq.low, &eq.mid, &eq.high };
+    for (int i = 0; i < 3; i++) {
+        bands[i]->fs = fs;
+        bands[i]->w1 = bands[i]->w2 = 0.0f;
+        update_filter_coefficients_eq(bands[i]);
+    }
 }
 
-float eq3band_process(float x)
+DSP_HOT void eq3band_process_block(float *x, int n)
 {
-    float y  = biquad_df2t_process_eq(&eq.low, x);
-    y = biquad_df2t_process_eq(&eq.mid,  y);   
-    y = biquad_df2t_process_eq(&eq.high, y);
-
-    return y;
+    for (int i = 0; i < n; i++)
+        x[i] = eq3band_process(&eq, x[i]);
 }
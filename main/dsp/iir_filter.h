@@ -2,15 +2,7 @@
 #include <stdint.h>
 #include <math.h>
 #include <stdio.h>
-
-typedef enum {
-    FILTER_LOW_PASS = 0,
-    FILTER_HIGH_PASS,
-    FILTER_BAND_PASS,
-    FILTER_PEAKING,
-    FILTER_LOW_SHELF,
-    FILTER_HIGH_SHELF
-} filter_type_t;
+#include "biquad.h"
 
 typedef struct {
     float b0, b1, b2, a1, a2;
@@ -18,6 +10,7 @@ typedef struct {
     float fc;
     float Q;
     float gain_db;
+    float fs;
     filter_type_t type;
 } eq_band_t;
 
@@ -30,11 +23,31 @@ typedef struct {
 typedef enum { EQ_BAND_LOW = 0, EQ_BAND_MID, EQ_BAND_HIGH } eq_band_id_t;
 
 const char* filter_type_to_str(filter_type_t type);
-void print_filter_status(void);
-float biquad_df2t_process_eq(eq_band_t *b, float x);
 void update_filter_coefficients_eq(eq_band_t *band);
-void eq_init(void);
-float eq3band_process(float x);
+void eq_init(float fs);
+void eq_set_sample_rate(float fs);      // clears state, coefficients follow from the registry
+void eq3band_process_block(float *x, int n);
 const eq_band_t* eq_get_band(eq_band_id_t id);
+eq3band_t *eq_state(void);              // audio task, for the inlined pipeline variants
+
+static inline float biquad_df2t_process_eq(eq_band_t *b, float x)
+{
+    float y = b->b0 * x + b->w1;
+    float w1_next = b->b1 * x + b->w2 - b->a1 * y;
+    float w2_next = b->b2 * x - b->a2 * y;
+
+    b->w1 = w1_next;
+    b->w2 = w2_next;
+
+    return y;
+}
+
+static inline float eq3band_process(eq3band_t *eq, float x)
+{
+    float y = biquad_df2t_process_eq(&eq->low, x);
+    y = biquad_df2t_process_eq(&eq->mid,  y);
+    y = biquad_df2t_process_eq(&eq->high, y);
+    return y;
+}
 void eq_get_all_bands(const eq_band_t **low, const eq_band_t **mid, const eq_band_t **high);
 
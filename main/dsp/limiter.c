@@ -1,4 +1,5 @@
 #include "limiter.h"
+#include "dsp_attr.h"
 #include <math.h>
 
 void limiter_init(limiter_t *l, float fs, float threshold, float attack_ms, float release_ms)
@@ -20,21 +21,8 @@ void limiter_init(limiter_t *l, float fs, float threshold, float attack_ms, floa
     l->gain = 1.0f;
 }
 
-float limiter_process(limiter_t *l, float x, float level)
+DSP_HOT void limiter_process_block(limiter_t *l, float *x, const float *level, int n)
 {
-    if (!l) return x;
-
-    float desired_gain = 1.0f;
-
-    if (level > l->threshold)
-        desired_gain = l->threshold / (level + 1e-9f);
-
-    if (desired_gain < l->gain)
-        l->gain = l->att_coeff * (l->gain - desired_gain) + desired_gain;  // attack
-    else
-        l->gain = l->rel_coeff * (l->gain - desired_gain) + desired_gain;  // release
-
-    float y = x * l->gain;
-
-    return y;
+    for (int i = 0; i < n; i++)
+        x[i] = limiter_process(l, x[i], level[i]);
 }
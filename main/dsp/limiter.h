@@ -15,6 +15,22 @@ typedef struct {
 
 void limiter_init(limiter_t *l, float fs, float threshold, float attack_ms, float release_ms);
 
-float limiter_process(limiter_t *l, float x, float level);
+// Per sample, inline so the pipeline variants compile into one loop
+static inline float limiter_process(limiter_t *l, float x, float level)
+{
+    float desired_gain = 1.0f;
+
+    if (level > l->threshold)
+        desired_gain = l->threshold / (level + 1e-9f);
+
+    if (desired_gain < l->gain)
+        l->gain = l->att_coeff * (l->gain - desired_gain) + desired_gain;  // attack
+    else
+        l->gain = l->rel_coeff * (l->gain - desired_gain) + desired_gain;  // release
+
+    return x * l->gain;
+}
+
+void  limiter_process_block(limiter_t *l, float *x, const float *level, int n);
 
 #endif // LIMITER_H
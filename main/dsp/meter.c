@@ -0,0 +1,191 @@
+#include "meter.h"
+#include "dsp_attr.h"
+#include "dsp_kernels.h"
+#include <string.h>
+
+#define METER_CHUNK 64
+
+// ITU-R BS.1770-4 Annex 2, 48-tap 4x interpolator split in 4 phases
+static const float DSP_RODATA tp_coeffs[METER_TP_PHASES][METER_TP_TAPS] = {
+    {  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f,
+      -0.0594482421875f,  0.1373291015625f,  0.9721679687500f, -0.1022949218750f,
+       0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f },
+    { -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f,
+      -0.1665039062500f,  0.4650878906250f,  0.7797851562500f, -0.2003173828125f,
+       0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+    { -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,  0.1015625000000f,
+      -0.2003173828125f,  0.7797851562500f,  0.4650878906250f, -0.1665039062500f,
+       0.0891113281250f, -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+    { -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,  0.0476074218750f,
+      -0.1022949218750f,  0.9721679687500f,  0.1373291015625f, -0.0594482421875f,
+       0.0332031250000f, -0.0196533203125f,  0.0109863281250f,  0.0017089843750f },
+};
+
+static inline float lin_to_db(float v)
+{
+    return 20.0f * log10f(fmaxf(v, 1e-9f));
+}
+
+static void meter_reset_window(meter_t *m)
+{
+    m->in_peak = 0.0f;
+    m->in_sum_sq = 0.0f;
+    m->out_peak = 0.0f;
+    m->out_tp = 0.0f;
+    m->out_sum_sq = 0.0f;
+    m->min_gain[0] = m->min_gain[1] = m->min_gain[2] = 1.0f;
+    m->n_samples = 0;
+    m->n_blocks = 0;
+}
+
+void meter_init(meter_t *m, float fs, int block_size, float window_ms)
+{
+    if (!m) return;
+    if (block_size <= 0) block_size = 128;
+    if (window_ms <= 0.0f) window_ms = 100.0f;
+
+    memset(m, 0, sizeof(*m));
+    meter_reset_window(m);
+    m->block_size = block_size;
+    m->window_ms = window_ms;
+    meter_set_sample_rate(m, fs);
+    atomic_init(&m->seq, 0u);
+}
+
+// Audio task: the window keeps its length in ms
+void meter_set_sample_rate(meter_t *m, float fs)
+{
+    m->fs = fs;
+    float blocks = (m->window_ms * 0.001f) * fs / (float)m->block_size;
+    m->window_blocks = (blocks < 1.0f) ? 1u : (uint32_t)(blocks + 0.5f);
+    meter_reset_window(m);
+}
+
+void meter_set_window(meter_t *m, float window_ms)
+{
+    if (window_ms <= 0.0f) return;
+    m->window_ms = window_ms;
+    meter_set_sample_rate(m, m->fs);
+}
+
+// 4x oversampled peak of the block, history carried between calls
+static DSP_HOT float true_peak_block(meter_t *m, const float *x, int n)
+{
+    float buf[METER_TP_TAPS - 1 + METER_CHUNK];
+    float peak = 0.0f;
+
+    while (n > 0) {
+        int len = (n > METER_CHUNK) ? METER_CHUNK : n;
+        memcpy(buf, m->tp_hist, sizeof(m->tp_hist));
+        memcpy(&buf[METER_TP_TAPS - 1], x, len * sizeof(float));
+
+        for (int i = 0; i < len; i++) {
+            const float *w = &buf[i + METER_TP_TAPS - 1];   // w[-k] = x[n-k]
+            for (int p = 0; p < METER_TP_PHASES; p++) {
+                const float *h = tp_coeffs[p];
+                float acc = 0.0f;
+                for (int k = 0; k < METER_TP_TAPS; k++)
+                    acc += h[k] * w[-k];
+                acc = fabsf(acc);
+                if (acc > peak) peak = acc;
+            }
+        }
+
+        memcpy(m->tp_hist, &buf[len], sizeof(m->tp_hist));
+        x += len;
+        n -= len;
+    }
+    return peak;
+}
+
+// Full-scale samples, only counted in blocks whose peak got there
+static inline uint32_t count_clips(const float *x, int n, float peak)
+{
+    if (peak < 1.0f) return 0;
+    uint32_t c = 0;
+    for (int i = 0; i < n; i++)
+        c += (fabsf(x[i]) >= 1.0f);
+    return c;
+}
+
+static void meter_publish(meter_t *m)
+{
+    float n = (m->n_samples > 0) ? (float)m->n_samples : 1.0f;
+    float out_rms_db = lin_to_db(sqrtf(m->out_sum_sq / n));
+    float out_pk_db  = lin_to_db(m->out_peak);
+
+    // seqlock write: odd sequence while the snapshot is inconsistent
+    unsigned s = atomic_load_explicit(&m->seq, memory_order_relaxed);
+    atomic_store_explicit(&m->seq, s + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    m->snap.in_peak_db       = lin_to_db(m->in_peak);
+    m->snap.in_rms_db        = lin_to_db(sqrtf(m->in_sum_sq / n));
+    m->snap.out_peak_db      = out_pk_db;
+    m->snap.out_true_peak_db = lin_to_db(m->out_tp);
+    m->snap.out_rms_db       = out_rms_db;
+    m->snap.crest_db         = out_pk_db - out_rms_db;
+    m->snap.gr_expander_db   = -lin_to_db(m->min_gain[0]);
+    m->snap.gr_compressor_db = -lin_to_db(m->min_gain[1]);
+    m->snap.gr_limiter_db    = -lin_to_db(m->min_gain[2]);
+    m->snap.in_clips         = m->in_clips;
+    m->snap.out_clips        = m->out_clips;
+    m->snap.seq              = (s + 2) >> 1;
+
+    atomic_store_explicit(&m->seq, s + 2, memory_order_release);
+}
+
+DSP_HOT void meter_process_block(meter_t *m, const float *in, const float *out, int n,
+                         float g_expander, float g_compressor, float g_limiter)
+{
+    float in_pk  = dsp_max_abs(in, n);
+    float out_pk = dsp_max_abs(out, n);
+    float in_sq  = dsp_sum_sq(in, n);
+    float out_sq = dsp_sum_sq(out, n);
+    uint32_t in_clip  = count_clips(in, n, in_pk);
+    uint32_t out_clip = count_clips(out, n, out_pk);
+
+    float tp = true_peak_block(m, out, n);
+
+    if (in_pk > m->in_peak)   m->in_peak = in_pk;
+    if (out_pk > m->out_peak) m->out_peak = out_pk;
+    if (tp > m->out_tp)       m->out_tp = tp;
+    m->in_sum_sq  += in_sq;
+    m->out_sum_sq += out_sq;
+    m->in_clips   += in_clip;
+    m->out_clips  += out_clip;
+    m->n_samples  += n;
+
+    // gain reduction is sampled once per block
+    if (g_expander   < m->min_gain[0]) m->min_gain[0] = g_expander;
+    if (g_compressor < m->min_gain[1]) m->min_gain[1] = g_compressor;
+    if (g_limiter    < m->min_gain[2]) m->min_gain[2] = g_limiter;
+
+    if (++m->n_blocks >= m->window_blocks) {
+        meter_publish(m);
+        meter_reset_window(m);
+    }
+}
+
+DSP_HOT void meter_count_clips(meter_t *m, const float *in, const float *out, int n)
+{
+    m->in_clips  += count_clips(in, n, dsp_max_abs(in, n));
+    m->out_clips += count_clips(out, n, dsp_max_abs(out, n));
+}
+
+bool meter_read(meter_t *m, meter_snapshot_t *out)
+{
+    if (!m || !out) return false;
+
+    unsigned s1, s2;
+    do {
+        s1 = atomic_load_explicit(&m->seq, memory_order_acquire);
+        if (s1 & 1u) continue;                  // writer in progress
+        *out = m->snap;
+        atomic_thread_fence(memory_order_acquire);
+        s2 = atomic_load_explicit(&m->seq, memory_order_relaxed);
+        if (s1 == s2) break;
+    } while (1);
+
+    return s1 != 0;
+}
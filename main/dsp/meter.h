@@ -0,0 +1,65 @@
+#ifndef METER_H
+#define METER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <math.h>
+
+#define METER_TP_PHASES   4     // true-peak oversampling (ITU-R BS.1770)
+#define METER_TP_TAPS     12    // taps per polyphase branch
+
+// Published every window (dB values, counters are totals since boot)
+typedef struct {
+    float in_peak_db;
+    float in_rms_db;
+    float out_peak_db;
+    float out_true_peak_db;
+    float out_rms_db;
+    float crest_db;             // out_peak_db - out_rms_db
+    float gr_expander_db;       // max gain reduction over the window (positive dB)
+    float gr_compressor_db;
+    float gr_limiter_db;
+    uint32_t in_clips;
+    uint32_t out_clips;
+    uint32_t seq;               // snapshot counter
+} meter_snapshot_t;
+
+typedef struct {
+    // window accumulators, audio task only
+    float in_peak;
+    float in_sum_sq;
+    float out_peak;
+    float out_tp;
+    float out_sum_sq;
+    float min_gain[3];          // expander, compressor, limiter
+    uint32_t n_samples;
+    uint32_t n_blocks;
+    uint32_t window_blocks;
+    int block_size;
+    float fs;
+    float window_ms;
+    uint32_t in_clips;
+    uint32_t out_clips;
+    float tp_hist[METER_TP_TAPS - 1];
+
+    // lock-free exchange (seqlock: single writer, any number of readers)
+    atomic_uint seq;
+    meter_snapshot_t snap;
+} meter_t;
+
+void meter_init(meter_t *m, float fs, int block_size, float window_ms);
+void meter_set_sample_rate(meter_t *m, float fs);
+void meter_set_window(meter_t *m, float window_ms);     // audio task, restarts the window
+
+// Called once per block by the audio task, after the sample loop.
+void meter_process_block(meter_t *m, const float *in, const float *out, int n,
+                         float g_expander, float g_compressor, float g_limiter);
+
+// Clip counters only, for blocks nobody meters
+void meter_count_clips(meter_t *m, const float *in, const float *out, int n);
+
+// Safe from any task. Returns false if no snapshot was published yet.
+bool meter_read(meter_t *m, meter_snapshot_t *out);
+
+#endif // METER_H
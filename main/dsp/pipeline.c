@@ -0,0 +1,263 @@
+#include "pipeline.h"
+#include "pipeline_static.h"
+#include "dsp_attr.h"
+#include "dsp_math.h"
+#include "dsp_kernels.h"
+#include "trace.h"
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+
+#include "iir_filter.h"
+#include "rms.h"
+#include "expander.h"
+#include "compressor.h"
+#include "limiter.h"
+#include "dyn_eq.h"
+
+// ---------------- stage adapters ----------------
+
+static DSP_HOT void stage_eq(void *s, dsp_block_t *b)
+{
+    (void)s;
+    eq3band_process_block(b->x, b->n);
+}
+
+static DSP_HOT void stage_dyneq(void *s, dsp_block_t *b)
+{
+    dyn_eq_process_block((dyn_eq_t *)s, b->x, b->n);
+}
+
+static DSP_HOT void stage_rms(void *s, dsp_block_t *b)
+{
+    rms_process_block((rms_filter_t *)s, b->x, b->level, b->n);
+}
+
+static DSP_HOT void stage_expander(void *s, dsp_block_t *b)
+{
+    expander_process_block((expander_t *)s, b->x, b->level, b->n);
+}
+
+static DSP_HOT void stage_compressor(void *s, dsp_block_t *b)
+{
+    compressor_process_block((compressor_t *)s, b->x, b->level, b->n);
+}
+
+static DSP_HOT void stage_limiter(void *s, dsp_block_t *b)
+{
+    limiter_process_block((limiter_t *)s, b->x, b->level, b->n);
+}
+
+static DSP_HOT void stage_softclip(void *s, dsp_block_t *b)
+{
+    (void)s;
+    for (int i = 0; i < b->n; i++)
+        b->x[i] = dsp_tanhf(b->x[i]);
+}
+
+typedef struct {
+    const char *name;
+    stage_fn_t process;
+    bool can_bypass;
+} stage_info_t;
+
+static const stage_info_t stage_info[STAGE_COUNT] = {
+    [STAGE_EQ]         = { "EQ",       stage_eq,         true  },
+    [STAGE_DYNEQ]      = { "DYNEQ",    stage_dyneq,      true  },
+    [STAGE_RMS]        = { "RMS",      stage_rms,        false },   // detector, feeds level[]
+    [STAGE_EXPANDER]   = { "EXPANDER", stage_expander,   true  },
+    [STAGE_COMPRESSOR] = { "COMP",     stage_compressor, true  },
+    [STAGE_LIMITER]    = { "LIMIT",    stage_limiter,    true  },
+    [STAGE_SOFTCLIP]   = { "SOFTCLIP", stage_softclip,   true  },
+};
+
+const char *stage_name(stage_id_t id)
+{
+    return (id < STAGE_COUNT) ? stage_info[id].name : "Unknown";
+}
+
+bool stage_from_name(const char *name, stage_id_t *id)
+{
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        if (strcasecmp(name, stage_info[i].name) == 0) {
+            *id = (stage_id_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool stage_can_bypass(stage_id_t id)
+{
+    return id < STAGE_COUNT && stage_info[id].can_bypass;
+}
+
+// ---------------- control side ----------------
+
+static void pipeline_build(const pipeline_t *p, pipeline_desc_t *d)
+{
+    unsigned active = 0;
+    bool default_order = true;
+
+    d->count = p->count;
+    for (int i = 0; i < p->count; i++) {
+        stage_id_t id = p->order[i];
+        d->stages[i].id      = id;
+        d->stages[i].process = stage_info[id].process;
+        d->stages[i].state   = p->state[id];
+        d->stages[i].bypass  = p->bypass[id];
+        if (!p->bypass[id]) active |= 1u << id;
+        if (id != (stage_id_t)i) default_order = false;
+    }
+
+    // variants only exist for the default order
+    d->active = active;
+    d->variant = (p->use_variants && default_order) ? pipeline_variant(active) : NULL;
+}
+
+void pipeline_init(pipeline_t *p, float fs, float fade_ms)
+{
+    if (!p) return;
+    memset(p, 0, sizeof(*p));
+    if (fade_ms <= 0.0f) fade_ms = 10.0f;
+
+    p->count = STAGE_COUNT;
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        p->order[i] = (stage_id_t)i;     // EQ → dynamic EQ → RMS → expander → compressor → limiter → tanh
+        p->mix[i] = 1.0f;
+    }
+    p->master_mix = 1.0f;
+    p->fade_ms = fade_ms;
+    p->settled = true;
+    p->use_variants = true;
+    pipeline_set_sample_rate(p, fs);
+
+    pipeline_build(p, &p->slots[0]);
+    p->active = &p->slots[0];
+    atomic_init(&p->pending, NULL);
+}
+
+// Audio task: crossfades keep their length in ms
+void pipeline_set_sample_rate(pipeline_t *p, float fs)
+{
+    p->fade_step = 1.0f / (fs * p->fade_ms * 0.001f);
+}
+
+void pipeline_bind(pipeline_t *p, stage_id_t id, void *state)
+{
+    if (!p || id >= STAGE_COUNT) return;
+    p->state[id] = state;
+    pipeline_build(p, p->active);        // only valid before the audio task starts
+}
+
+bool pipeline_set_bypass(pipeline_t *p, stage_id_t id, bool bypass)
+{
+    if (!p || !stage_can_bypass(id)) return false;
+    p->bypass[id] = bypass;
+    return true;
+}
+
+bool pipeline_set_order(pipeline_t *p, const stage_id_t *order, int count)
+{
+    if (!p || !order || count != STAGE_COUNT) return false;
+
+    bool seen[STAGE_COUNT] = {0};
+    for (int i = 0; i < count; i++) {
+        if (order[i] >= STAGE_COUNT || seen[order[i]]) return false;
+        seen[order[i]] = true;
+    }
+    memcpy(p->order, order, sizeof(p->order));
+    return true;
+}
+
+void pipeline_use_variants(pipeline_t *p, bool on)
+{
+    if (p) p->use_variants = on;
+}
+
+bool pipeline_commit(pipeline_t *p)
+{
+    // previous descriptor not picked up yet: its slot is still in flight
+    if (atomic_load_explicit(&p->pending, memory_order_acquire) != NULL)
+        return false;
+
+    pipeline_desc_t *next = (p->active == &p->slots[0]) ? &p->slots[1] : &p->slots[0];
+    pipeline_build(p, next);
+    atomic_store_explicit(&p->pending, next, memory_order_release);
+    return true;
+}
+
+// ---------------- audio task ----------------
+
+// x = dry + (x - dry) * mix, with mix ramping toward target (0 or 1)
+static DSP_HOT void crossfade(float *x, const float *dry, int n, float *mix, float target, float step)
+{
+    float m = *mix;
+    float d = (target > m) ? step : -step;
+
+    // ramp samples up to the one that reaches target, the rest sit on it
+    int k = (int)(fabsf(target - m) / step);
+    if (k > n) k = n;
+    dsp_mix_ramp(x, dry, k, m, d);
+    if (k < n && target == 0.0f)
+        memcpy(&x[k], &dry[k], (n - k) * sizeof(float));
+
+    m = (k < n) ? target : m + (float)k * d;
+    *mix = dsp_clampf(m, 0.0f, 1.0f);
+}
+
+DSP_HOT void pipeline_process(pipeline_t *p, float *x, int n, bool enabled)
+{
+    // block boundary: adopt the latest descriptor
+    pipeline_desc_t *next = atomic_load_explicit(&p->pending, memory_order_acquire);
+    if (next) {
+        p->active = next;
+        p->settled = false;
+        atomic_store_explicit(&p->pending, NULL, memory_order_release);
+    }
+
+    float master_target = enabled ? 1.0f : 0.0f;
+    if (p->master_mix == 0.0f && master_target == 0.0f) return;    // full bypass
+
+    bool master_fade = (p->master_mix != master_target);
+    const pipeline_desc_t *d = p->active;
+
+    // steady state: the whole chain as one precompiled block function
+    if (d->variant && p->settled && !master_fade && n == PIPELINE_STATIC_BLOCK) {
+        TRACE_BEGIN(TRACE_STAGE + STAGE_COUNT);
+        d->variant(p->state, x, d->active);
+        TRACE_END(TRACE_STAGE + STAGE_COUNT);
+        return;
+    }
+
+    if (master_fade) memcpy(p->chain_dry, x, n * sizeof(float));
+
+    dsp_block_t blk = { .x = x, .level = p->level, .n = n };
+    bool settled = true;
+
+    for (int s = 0; s < d->count; s++) {
+        const pipeline_stage_t *st = &d->stages[s];
+        float *mix = &p->mix[st->id];
+        float target = st->bypass ? 0.0f : 1.0f;
+
+        if (*mix == target) {
+            if (target != 0.0f) {
+                TRACE_BEGIN(TRACE_STAGE + st->id);
+                st->process(st->state, &blk);
+                TRACE_END(TRACE_STAGE + st->id);
+            }
+            continue;                                           // bypassed: no work
+        }
+
+        memcpy(p->dry, x, n * sizeof(float));
+        TRACE_BEGIN(TRACE_STAGE + st->id);
+        st->process(st->state, &blk);
+        TRACE_END(TRACE_STAGE + st->id);
+        crossfade(x, p->dry, n, mix, target, p->fade_step);
+        if (*mix != target) settled = false;
+    }
+    p->settled = settled;
+
+    if (master_fade)
+        crossfade(x, p->chain_dry, n, &p->master_mix, master_target, p->fade_step);
+}
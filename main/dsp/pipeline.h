@@ -0,0 +1,89 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#define PIPELINE_MAX_BLOCK  256     // largest CONFIG_AUDIO_BLOCK_SIZE
+
+typedef enum {
+    STAGE_EQ = 0,
+    STAGE_DYNEQ,
+    STAGE_RMS,
+    STAGE_EXPANDER,
+    STAGE_COMPRESSOR,
+    STAGE_LIMITER,
+    STAGE_SOFTCLIP,
+    STAGE_COUNT
+} stage_id_t;
+
+// Block handed from stage to stage, x is processed in place
+typedef struct {
+    float *x;
+    float *level;       // detector output, written by the RMS stage
+    int n;
+} dsp_block_t;
+
+typedef void (*stage_fn_t)(void *state, dsp_block_t *blk);
+
+// Whole chain for one stage combination, state[] indexed by stage_id_t,
+// active = running stages as a mask of (1 << stage_id_t)
+typedef void (*pipeline_variant_fn_t)(void *const *state, float *x, unsigned active);
+
+typedef struct {
+    stage_id_t id;
+    stage_fn_t process;
+    void *state;
+    bool bypass;
+} pipeline_stage_t;
+
+typedef struct {
+    pipeline_stage_t stages[STAGE_COUNT];
+    int count;
+    pipeline_variant_fn_t variant;  // precompiled chain for this descriptor, or NULL
+    unsigned active;                // running stages, 1 << stage_id_t
+} pipeline_desc_t;
+
+typedef struct {
+    // descriptors: the audio task runs `active`, the control side publishes `pending`
+    pipeline_desc_t slots[2];
+    pipeline_desc_t *active;
+    _Atomic(pipeline_desc_t *) pending;
+
+    // control side copy, edited by the UART task then committed
+    stage_id_t order[STAGE_COUNT];
+    bool bypass[STAGE_COUNT];
+    int count;
+    void *state[STAGE_COUNT];
+    bool use_variants;          // PIPE STATIC, off forces the generic loop
+
+    // audio task only
+    float mix[STAGE_COUNT];     // 0 = bypassed .. 1 = processed
+    float master_mix;
+    float fade_step;            // mix change per sample
+    float fade_ms;
+    bool settled;               // no stage fade in progress
+    float level[PIPELINE_MAX_BLOCK];
+    float dry[PIPELINE_MAX_BLOCK];
+    float chain_dry[PIPELINE_MAX_BLOCK];
+} pipeline_t;
+
+void pipeline_init(pipeline_t *p, float fs, float fade_ms);
+void pipeline_bind(pipeline_t *p, stage_id_t id, void *state);
+void pipeline_set_sample_rate(pipeline_t *p, float fs);
+
+// Control side: edit the copy, then commit() swaps it in at the next block
+bool pipeline_set_bypass(pipeline_t *p, stage_id_t id, bool bypass);
+bool pipeline_set_order(pipeline_t *p, const stage_id_t *order, int count);
+void pipeline_use_variants(pipeline_t *p, bool on);
+bool pipeline_commit(pipeline_t *p);
+
+// Audio task: x is processed in place, enabled crossfades the whole chain.
+// Blocks of the variant length run the precompiled chain once settled.
+void pipeline_process(pipeline_t *p, float *x, int n, bool enabled);
+
+const char *stage_name(stage_id_t id);
+bool stage_from_name(const char *name, stage_id_t *id);
+bool stage_can_bypass(stage_id_t id);
+
+#endif // PIPELINE_H
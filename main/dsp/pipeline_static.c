@@ -0,0 +1,100 @@
+#include "pipeline_static.h"
+#include "dsp_attr.h"
+#include "dsp_math.h"
+#include <math.h>
+
+#include "iir_filter.h"
+#include "rms.h"
+#include "expander.h"
+#include "compressor.h"
+#include "limiter.h"
+#include "dyn_eq.h"
+
+#if CONFIG_AUDIO_STATIC_PIPELINE
+
+#define S_EQ    (1u << STAGE_EQ)
+#define S_DYN   (1u << STAGE_DYNEQ)
+#define S_EXP   (1u << STAGE_EXPANDER)
+#define S_COMP  (1u << STAGE_COMPRESSOR)
+#define S_LIM   (1u << STAGE_LIMITER)
+#define S_CLIP  (1u << STAGE_SOFTCLIP)
+
+#if (PIPELINE_STATIC_STAGES & ~(S_EQ | S_EXP | S_COMP | S_LIM))
+#error "only EQ, expander, compressor and limiter are variant stages"
+#endif
+
+// RMS → expander → compressor → limiter on one sample; the level is the
+// detector output before the expander, as in the generic chain
+static inline __attribute__((always_inline))
+float chain_dynamics(void *const *st, float v, const unsigned m)
+{
+    float level = rms_process((rms_filter_t *)st[STAGE_RMS], v);
+    if (m & S_EXP)  v = expander_process((expander_t *)st[STAGE_EXPANDER], v, level);
+    if (m & S_COMP) v = compressor_process((compressor_t *)st[STAGE_COMPRESSOR], v, level);
+    if (m & S_LIM)  v = limiter_process((limiter_t *)st[STAGE_LIMITER], v, level);
+    return v;
+}
+
+// m is a constant in every variant: the stage tests fold away and the
+// sample loops have a fixed trip count. The dynamic EQ (own control-rate
+// loop) and the soft clip are whole-block passes tested once per block.
+static inline __attribute__((always_inline))
+void chain(void *const *st, float *x, const unsigned m, unsigned active)
+{
+    const int n = PIPELINE_STATIC_BLOCK;
+
+    if (m & S_EQ) {
+        eq3band_t *eq = eq_state();
+        for (int i = 0; i < n; i++) x[i] = eq3band_process(eq, x[i]);
+    }
+    if (active & S_DYN)
+        dyn_eq_process_block((dyn_eq_t *)st[STAGE_DYNEQ], x, n);
+    for (int i = 0; i < n; i++)
+        x[i] = chain_dynamics(st, x[i], m);
+    if (active & S_CLIP)
+        for (int i = 0; i < n; i++) x[i] = dsp_tanhf(x[i]);
+}
+
+// one variant per combination of the four sample-fused stages
+#define VBITS(a, b, c, d)  ((a) * S_EQ | (b) * S_EXP | (c) * S_COMP | (d) * S_LIM)
+
+#define V(a, b, c, d)                                                                    \
+    static DSP_HOT void variant_##a##b##c##d(void *const *st, float *x, unsigned active) \
+    { chain(st, x, VBITS(a, b, c, d), active); }
+#define V3(a, b, c)  V(a, b, c, 0) V(a, b, c, 1)
+#define V2(a, b)     V3(a, b, 0) V3(a, b, 1)
+#define V1(a)        V2(a, 0) V2(a, 1)
+V1(0) V1(1)
+
+// combinations using a stage left out of the build stay NULL, and so do
+// the ones with neither the expander nor the limiter: RMS, EQ and the
+// compressor alone or together measure no faster fused than in the generic
+// loop (median 0.99-1.02x in tools/pipeline_bench.c)
+#define S_FUSED_WIN  (S_EXP | S_LIM)
+
+#define T(a, b, c, d)                                                               \
+    [VBITS(a, b, c, d)] =                                                           \
+        ((VBITS(a, b, c, d) & ~PIPELINE_STATIC_STAGES) ||                           \
+         !(VBITS(a, b, c, d) & S_FUSED_WIN)) ? NULL : variant_##a##b##c##d,
+#define T3(a, b, c)  T(a, b, c, 0) T(a, b, c, 1)
+#define T2(a, b)     T3(a, b, 0) T3(a, b, 1)
+#define T1(a)        T2(a, 0) T2(a, 1)
+
+#define VARIANT_SLOTS  (1u << STAGE_COUNT)
+
+static const pipeline_variant_fn_t variants[VARIANT_SLOTS] = { T1(0) T1(1) };
+
+pipeline_variant_fn_t pipeline_variant(unsigned active)
+{
+    return variants[active & (S_EQ | S_EXP | S_COMP | S_LIM)];
+}
+
+#else
+
+pipeline_variant_fn_t pipeline_variant(unsigned active)
+{
+    (void)active;
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef PIPELINE_STATIC_H
+#define PIPELINE_STATIC_H
+
+#include "pipeline.h"
+
+// Precompiled pipeline variants (CONFIG_AUDIO_STATIC_PIPELINE): one
+// straight-line block function per bypass combination of the selected
+// sample-rate stages (EQ, expander, compressor, limiter), default stage
+// order, fixed block length.
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#else
+// host tools: every stage, default block unless given with -D
+#define CONFIG_AUDIO_STATIC_PIPELINE    1
+#define CONFIG_AUDIO_STATIC_EQ          1
+#define CONFIG_AUDIO_STATIC_EXPANDER    1
+#define CONFIG_AUDIO_STATIC_COMP        1
+#define CONFIG_AUDIO_STATIC_LIMIT       1
+#ifndef CONFIG_AUDIO_BLOCK_SIZE
+#define CONFIG_AUDIO_BLOCK_SIZE         128
+#endif
+#endif
+
+#ifndef CONFIG_AUDIO_STATIC_EQ
+#define CONFIG_AUDIO_STATIC_EQ          0
+#endif
+#ifndef CONFIG_AUDIO_STATIC_EXPANDER
+#define CONFIG_AUDIO_STATIC_EXPANDER    0
+#endif
+#ifndef CONFIG_AUDIO_STATIC_COMP
+#define CONFIG_AUDIO_STATIC_COMP        0
+#endif
+#ifndef CONFIG_AUDIO_STATIC_LIMIT
+#define CONFIG_AUDIO_STATIC_LIMIT       0
+#endif
+
+#define PIPELINE_STATIC_BLOCK   CONFIG_AUDIO_BLOCK_SIZE
+
+// Stages fused into the variants, as a mask of (1 << stage_id_t). RMS runs
+// in every variant, the dynamic EQ and soft clip are block passes.
+#define PIPELINE_STATIC_STAGES                                  \
+    ((CONFIG_AUDIO_STATIC_EQ       ? 1u << STAGE_EQ         : 0) | \
+     (CONFIG_AUDIO_STATIC_EXPANDER ? 1u << STAGE_EXPANDER   : 0) | \
+     (CONFIG_AUDIO_STATIC_COMP     ? 1u << STAGE_COMPRESSOR : 0) | \
+     (CONFIG_AUDIO_STATIC_LIMIT    ? 1u << STAGE_LIMITER    : 0))
+
+// Variant for the stages in `active` (mask of 1 << stage_id_t), NULL when
+// that combination was not compiled in or runs no faster fused
+pipeline_variant_fn_t pipeline_variant(unsigned active);
+
+#endif // PIPELINE_STATIC_H
@@ -0,0 +1,195 @@
+#include "pitch.h"
+#include <string.h>
+#include <math.h>
+#include "dsp_kernels.h"
+#include "esp_dsp.h"
+
+#define MAX_KEYS  (PITCH_WINDOW / 8)     // positive NSDF lobes considered
+
+_Static_assert(PITCH_FFT >= 2 * PITCH_WINDOW, "autocorrelation must not wrap");
+
+void pitch_init(pitch_t *p, float fs, float hop_ms)
+{
+    memset(p, 0, sizeof(*p));
+    halfband_design();
+    dsps_fft2r_init_fc32(NULL, PITCH_FFT);     // no-op when fft_init() got there first
+    p->hop_ms = hop_ms;
+    pitch_set_sample_rate(p, fs);
+}
+
+// Smallest power-of-two decimation down to PITCH_RATE_MAX
+void pitch_set_sample_rate(pitch_t *p, float fs)
+{
+    int stages = 0;
+    while (stages < PITCH_MAX_STAGES && fs / (float)(1 << stages) > PITCH_RATE_MAX)
+        stages++;
+
+    p->fs = fs;
+    p->stages = stages;
+    p->rate = fs / (float)(1 << stages);
+    p->lag_min = (int)floorf(p->rate / PITCH_F0_MAX);
+    p->lag_max = (int)ceilf(p->rate / PITCH_F0_MIN);
+    if (p->lag_min < 2) p->lag_min = 2;
+    if (p->lag_max > PITCH_WINDOW / 2) p->lag_max = PITCH_WINDOW / 2;
+
+    for (int s = 0; s < PITCH_MAX_STAGES; s++) halfband_reset(&p->hb[s]);
+    p->fill = 0;
+    p->since = 0;
+    p->f0 = 0.0f;
+    p->clarity = 0.0f;
+    p->voiced = false;
+    pitch_set_hop(p, p->hop_ms);
+}
+
+void pitch_set_hop(pitch_t *p, float hop_ms)
+{
+    if (hop_ms < PITCH_HOP_MS_MIN) hop_ms = PITCH_HOP_MS_MIN;
+    if (hop_ms > PITCH_HOP_MS_MAX) hop_ms = PITCH_HOP_MS_MAX;
+    p->hop_ms = hop_ms;
+    p->hop = (int)(hop_ms * 0.001f * p->rate + 0.5f);
+    if (p->hop < 1) p->hop = 1;
+    if (p->since > p->hop) p->since = p->hop;   // a shorter hop is due now, not skipped
+}
+
+// r(τ) for τ <= lag_max + 1: |FFT(x)|² back through the same forward FFT,
+// which is its own inverse up to 1/N for a real, even spectrum
+static void pitch_autocorr(pitch_t *p, const float *x)
+{
+    float *f = p->fft;
+    for (int i = 0; i < PITCH_WINDOW; i++) {
+        f[2 * i] = x[i];
+        f[2 * i + 1] = 0.0f;
+    }
+    memset(&f[2 * PITCH_WINDOW], 0, 2 * (PITCH_FFT - PITCH_WINDOW) * sizeof(float));
+
+    dsps_fft2r_fc32(f, PITCH_FFT);
+    dsps_bit_rev_fc32(f, PITCH_FFT);
+    dsp_power_spectrum(f, p->power, PITCH_FFT);
+
+    for (int i = 0; i < PITCH_FFT; i++) {
+        f[2 * i] = p->power[i];
+        f[2 * i + 1] = 0.0f;
+    }
+    dsps_fft2r_fc32(f, PITCH_FFT);
+    dsps_bit_rev_fc32(f, PITCH_FFT);
+}
+
+// Vertex of the parabola through y[-1], y[0], y[1]; *d is its offset
+static float parabolic_peak(const float *y, float *d)
+{
+    float den = y[-1] - 2.0f * y[0] + y[1];
+    if (den >= 0.0f) {
+        *d = 0.0f;
+        return y[0];
+    }
+    *d = 0.5f * (y[-1] - y[1]) / den;
+    return y[0] - 0.25f * (y[-1] - y[1]) * *d;
+}
+
+void pitch_analyze(pitch_t *p, const float *w)
+{
+    float *x = p->sq;           // mean-removed window, then its squares
+    float mean = 0.0f;
+    for (int i = 0; i < PITCH_WINDOW; i++) mean += w[i];
+    mean *= 1.0f / PITCH_WINDOW;
+    for (int i = 0; i < PITCH_WINDOW; i++) x[i] = w[i] - mean;
+
+    p->frames++;
+    p->f0 = 0.0f;
+    p->clarity = 0.0f;
+    p->voiced = false;
+
+    float energy = dsp_sum_sq(x, PITCH_WINDOW);
+    if (energy < PITCH_POWER_MIN * PITCH_WINDOW) return;
+
+    pitch_autocorr(p, x);
+    for (int i = 0; i < PITCH_WINDOW; i++) x[i] *= x[i];
+
+    // NSDF n(τ) = 2 r(τ) / m(τ), m(τ) = Σ x[j]² + x[j+τ]² over the overlap
+    const float scale = 2.0f / PITCH_FFT;
+    int last = p->lag_max + 1;
+    float m = 2.0f * energy;
+    for (int t = 0; t <= last; t++) {
+        p->nsdf[t] = (m > 0.0f) ? scale * p->fft[2 * t] / m : 0.0f;
+        m -= x[PITCH_WINDOW - 1 - t] + x[t];
+    }
+
+    // Key maxima: the highest point of each positive lobe after the first
+    // negative zero crossing, within the lag range
+    int keys[MAX_KEYS];
+    int nkeys = 0, best = -1;
+    bool started = false;
+    for (int t = 1; t < last; t++) {
+        float v = p->nsdf[t];
+        if (!started) {
+            started = (v < 0.0f);
+            continue;
+        }
+        if (v > 0.0f && t >= p->lag_min) {
+            if (best < 0 || v > p->nsdf[best]) best = t;
+        }
+        if ((v <= 0.0f || t == last - 1) && best >= 0) {
+            // a lobe cut by the lag range only counts if it peaks inside it
+            float pk = p->nsdf[best];
+            if (pk >= p->nsdf[best - 1] && pk >= p->nsdf[best + 1] &&
+                nkeys < MAX_KEYS)
+                keys[nkeys++] = best;
+            best = -1;
+        }
+    }
+    if (nkeys == 0) return;
+
+    // compare interpolated peaks: at a few samples per period the sampled
+    // first maximum can sit well below the next, integer-lag one
+    float peaks[MAX_KEYS], offs[MAX_KEYS];
+    float top = 0.0f;
+    for (int k = 0; k < nkeys; k++) {
+        peaks[k] = parabolic_peak(&p->nsdf[keys[k]], &offs[k]);
+        top = fmaxf(top, peaks[k]);
+    }
+
+    int k = 0;
+    while (k < nkeys - 1 && peaks[k] < PITCH_K * top) k++;
+
+    p->f0 = p->rate / ((float)keys[k] + offs[k]);
+    p->clarity = fminf(peaks[k], 1.0f);
+    p->voiced = p->clarity >= PITCH_CLARITY_MIN &&
+                p->f0 >= PITCH_F0_MIN && p->f0 <= PITCH_F0_MAX;
+    if (!p->voiced) p->f0 = 0.0f;
+}
+
+bool pitch_process(pitch_t *p, const float *x, int n)
+{
+    float a[HALFBAND_MAX_BLOCK], b[HALFBAND_MAX_BLOCK / 2];
+    const float *in = x;
+    float *y = a, *z = b;
+    for (int s = 0; s < p->stages; s++) {
+        n = halfband_decimate(&p->hb[s], in, n, y);
+        in = y;
+        float *t = y; y = z; z = t;         // ping-pong, outputs shrink each stage
+    }
+
+    // slide the history, oldest first
+    bool filling = p->fill < PITCH_WINDOW;
+    if (n >= PITCH_WINDOW) {
+        memcpy(p->hist, &in[n - PITCH_WINDOW], sizeof(p->hist));
+        p->fill = PITCH_WINDOW;
+    } else if (p->fill + n <= PITCH_WINDOW) {
+        memcpy(&p->hist[p->fill], in, n * sizeof(float));
+        p->fill += n;
+    } else {
+        int keep = PITCH_WINDOW - n;
+        memmove(p->hist, &p->hist[p->fill - keep], keep * sizeof(float));
+        memcpy(&p->hist[keep], in, n * sizeof(float));
+        p->fill = PITCH_WINDOW;
+    }
+
+    // first analysis as soon as the window is full, then one per hop
+    p->since = filling ? p->hop : p->since + n;
+    if (p->fill < PITCH_WINDOW || p->since < p->hop) return false;
+
+    p->skipped += p->since / p->hop - 1;
+    p->since %= p->hop;
+    pitch_analyze(p, p->hist);
+    return true;
+}
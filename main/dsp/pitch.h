@@ -0,0 +1,60 @@
+#ifndef PITCH_H
+#define PITCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "halfband.h"
+
+// F0 tracker, McLeod pitch method: normalised square difference (NSDF) of
+// a decimated window, autocorrelation through two esp-dsp FFTs.
+#define PITCH_MAX_STAGES   3        // 48 kHz → 6 kHz
+#define PITCH_RATE_MAX     8000     // analysis rate after decimation
+#define PITCH_WINDOW       256      // analysis window, decimated samples
+#define PITCH_FFT          512      // 2x zero padding: no circular wrap, same table as fft.c
+#define PITCH_F0_MIN       65.0f
+#define PITCH_F0_MAX       1000.0f
+#define PITCH_K            0.85f    // first NSDF key maximum within K of the highest wins
+#define PITCH_CLARITY_MIN  0.6f     // NSDF peak for a voiced decision
+#define PITCH_POWER_MIN    1e-6f    // mean square below this is unvoiced (-60 dBFS)
+#define PITCH_HOP_MS       20.0f    // default
+#define PITCH_HOP_MS_MIN   5.0f
+#define PITCH_HOP_MS_MAX   200.0f
+
+typedef struct {
+    halfband_t hb[PITCH_MAX_STAGES];
+    int stages;
+    float fs;                   // input rate
+    float rate;                 // analysis rate
+    float hop_ms;
+    int hop;                    // decimated samples between analyses
+    int lag_min, lag_max;
+
+    float hist[PITCH_WINDOW];   // latest decimated samples, oldest first
+    int fill;
+    int since;                  // decimated samples since the last analysis
+    uint32_t skipped;           // hops dropped to keep one analysis per call
+
+    float fft[2 * PITCH_FFT];
+    float power[PITCH_FFT];
+    float sq[PITCH_WINDOW];
+    float nsdf[PITCH_WINDOW / 2 + 2];
+
+    // last analysis
+    float f0;                   // Hz, 0 when unvoiced
+    float clarity;              // NSDF peak, 0..1
+    bool voiced;
+    uint32_t frames;
+} pitch_t;
+
+void pitch_init(pitch_t *p, float fs, float hop_ms);
+void pitch_set_sample_rate(pitch_t *p, float fs);   // restarts the history
+void pitch_set_hop(pitch_t *p, float hop_ms);
+
+// n input samples (even, <= HALFBAND_MAX_BLOCK). Runs at most one analysis,
+// true when it did; a backlog of several hops is skipped, not caught up.
+bool pitch_process(pitch_t *p, const float *x, int n);
+
+// One analysis of PITCH_WINDOW samples at p->rate, updates f0/clarity/voiced
+void pitch_analyze(pitch_t *p, const float *w);
+
+#endif // PITCH_H
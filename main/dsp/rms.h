@@ -5,15 +5,23 @@
 typedef struct {
     float rms_sq;
     float alpha;
+    float tau_ms;
 } rms_filter_t;
 
 void  rms_init(rms_filter_t *r, float fs, float tau_ms);
+void  rms_set_sample_rate(rms_filter_t *r, float fs);
 
 static inline float rms_process(rms_filter_t *r, float x) {
     r->rms_sq = (1.0f - r->alpha) * r->rms_sq + r->alpha * (x * x);
     return sqrtf(r->rms_sq);
 }
 
+// Block version: level[i] receives the running RMS after x[i]
+static inline void rms_process_block(rms_filter_t *r, const float *x, float *level, int n) {
+    for (int i = 0; i < n; i++)
+        level[i] = rms_process(r, x[i]);
+}
+
 static inline float rms_get_dbfs(const rms_filter_t *r) {
     float rms = (r->rms_sq > 0.0f) ? sqrtf(r->rms_sq) : 0.0f;
     if (rms < 1e-12f) rms = 1e-12f;
@@ -0,0 +1,161 @@
+#include "vad.h"
+#include "dsp_attr.h"
+#include "dsp_math.h"
+
+// fft_bands(): 60-120-250-500-1k-2k-4k-8k-16k, speech bands are 2..5
+#define VAD_SPEECH_BAND_FIRST 2
+#define VAD_SPEECH_BAND_LAST  5
+
+#define VAD_ABS_FLOOR_DB  -75.0f    // below this the block is silence
+#define VAD_HISS_ZCR_HZ   7000.0f   // crossings/s above which it sounds like hiss
+
+const char *vad_state_to_str(vad_state_t s)
+{
+    switch (s) {
+        case VAD_SILENCE:  return "SILENCE";
+        case VAD_ONSET:    return "ONSET";
+        case VAD_SPEECH:   return "SPEECH";
+        case VAD_HANGOVER: return "HANGOVER";
+        default:           return "Unknown";
+    }
+}
+
+// Block-rate time constants, recomputed when the sample rate changes
+void vad_set_sample_rate(vad_t *v, float fs)
+{
+    float block_ms = 1000.0f * (float)v->block_size / fs;
+
+    v->fs = fs;
+    v->onset_blocks    = (int)(10.0f / block_ms + 0.5f) + 1;    // ~10 ms
+    v->hangover_blocks = (int)(v->hangover_ms / block_ms + 0.5f);
+
+    // floor follows drops within ~50 ms, rises at 3 dB/s
+    v->noise_fall = 1.0f - expf(-block_ms / 50.0f);
+    v->noise_rise = 3.0f * block_ms * 0.001f;
+    v->smooth     = 1.0f - expf(-block_ms / 20.0f);
+}
+
+void vad_init(vad_t *v, float fs, int block_size, float hangover_ms)
+{
+    if (!v) return;
+    if (block_size <= 0) block_size = 128;
+    if (hangover_ms <= 0.0f) hangover_ms = 300.0f;
+
+    v->block_size  = block_size;
+    v->hangover_ms = hangover_ms;
+    v->prob_on  = 0.6f;
+    v->prob_off = 0.4f;
+    vad_set_sample_rate(v, fs);
+    v->noise_db   = 0.0f;
+    v->seeded     = false;    // the first block sets the floor
+
+    v->power      = 0.0f;
+    v->energy_db  = -120.0f;
+    v->zcr        = 0.0f;
+    v->flatness   = 1.0f;
+    v->band_ratio = 0.5f;
+    v->last_x     = 0.0f;
+
+    v->prob    = 0.0f;
+    v->state   = VAD_SILENCE;
+    v->counter = 0;
+    v->speech  = false;
+}
+
+void vad_update_spectrum(vad_t *v, const float *bands_db)
+{
+    if (!v || !bands_db) return;
+
+    float sum = 0.0f, log_sum = 0.0f, speech = 0.0f;
+    for (int b = 0; b < VAD_BANDS; b++) {
+        float p = powf(10.0f, bands_db[b] * 0.1f) + 1e-12f;
+        sum += p;
+        log_sum += logf(p);
+        if (b >= VAD_SPEECH_BAND_FIRST && b <= VAD_SPEECH_BAND_LAST)
+            speech += p;
+    }
+
+    float arith = sum / VAD_BANDS;
+    float geo   = expf(log_sum / VAD_BANDS);
+    v->flatness   = dsp_clampf(geo / arith, 0.0f, 1.0f);
+    v->band_ratio = speech / sum;
+}
+
+static DSP_HOT void vad_step(vad_t *v)
+{
+    bool hi = v->prob >= v->prob_on;
+    bool lo = v->prob <  v->prob_off;
+
+    switch (v->state) {
+        case VAD_SILENCE:
+            if (hi) { v->state = VAD_ONSET; v->counter = 1; }
+            break;
+
+        case VAD_ONSET:
+            if (!hi)                               v->state = VAD_SILENCE;
+            else if (++v->counter >= v->onset_blocks) v->state = VAD_SPEECH;
+            break;
+
+        case VAD_SPEECH:
+            if (lo) { v->state = VAD_HANGOVER; v->counter = v->hangover_blocks; }
+            break;
+
+        case VAD_HANGOVER:
+            if (hi)                    v->state = VAD_SPEECH;
+            else if (--v->counter <= 0) v->state = VAD_SILENCE;
+            break;
+    }
+
+    v->speech = (v->state == VAD_SPEECH || v->state == VAD_HANGOVER);
+}
+
+DSP_HOT bool vad_process_block(vad_t *v, const float *x, int n)
+{
+    if (n <= 0) return v->speech;
+
+    // energy + zero crossings
+    float sum_sq = 0.0f;
+    int crossings = 0;
+    float prev = v->last_x;
+    for (int i = 0; i < n; i++) {
+        sum_sq += x[i] * x[i];
+        crossings += ((x[i] >= 0.0f) != (prev >= 0.0f));
+        prev = x[i];
+    }
+    v->last_x = prev;
+
+    // ~20 ms power average, a single block is too short for low-frequency noise
+    v->power += v->smooth * (sum_sq / (float)n - v->power);
+    v->energy_db = 0.5f * DSP_DB_PER_LOG2 * dsp_log2f(v->power + 1e-12f);
+    v->zcr = (float)crossings / (float)n;
+
+    // noise floor: fast down, slow up
+    if (!v->seeded) {
+        v->noise_db = 0.5f * DSP_DB_PER_LOG2 * dsp_log2f(sum_sq / (float)n + 1e-12f);
+        v->seeded = true;
+    } else if (v->energy_db < v->noise_db)
+        v->noise_db += v->noise_fall * (v->energy_db - v->noise_db);
+    else
+        v->noise_db += v->noise_rise;
+
+    // feature score → probability
+    float snr    = v->energy_db - v->noise_db;
+    float s_snr  = dsp_clampf((snr - 3.0f) / 9.0f, 0.0f, 1.0f);
+    float s_hiss = (v->zcr * v->fs > VAD_HISS_ZCR_HZ) ? 1.0f : 0.0f;
+
+    float s_flat = dsp_clampf((v->flatness - 0.6f) / 0.4f, 0.0f, 1.0f);
+
+    float z = -3.0f
+            + 5.0f * s_snr
+            + 4.0f * (v->band_ratio - 0.3f)
+            - 2.0f * s_flat
+            - 2.0f * s_hiss;
+
+    float p = 1.0f / (1.0f + dsp_exp2f(-1.44269504f * z));     // e^-z
+    if (v->energy_db < VAD_ABS_FLOOR_DB) p = 0.0f;
+
+    v->prob += v->smooth * (p - v->prob);
+
+    vad_step(v);
+    return v->speech;
+}
@@ -0,0 +1,62 @@
+#ifndef VAD_H
+#define VAD_H
+
+#include <stdbool.h>
+#include <math.h>
+
+#define VAD_BANDS 8     // fft_bands() layout
+#define VAD_SPECTRUM_HZ 25  // spectral feature refresh the decision needs
+#define VAD_SILENCE_DIV 4   // spectrum refresh divider while the VAD reports silence
+
+typedef enum {
+    VAD_SILENCE = 0,
+    VAD_ONSET,          // speech seen, waiting for confirmation
+    VAD_SPEECH,
+    VAD_HANGOVER        // speech ended, holding the flag open
+} vad_state_t;
+
+typedef struct {
+    // config (in blocks)
+    int onset_blocks;
+    int hangover_blocks;
+    float prob_on;
+    float prob_off;
+    float fs;
+    int block_size;
+    float hangover_ms;
+
+    // noise floor tracker (dB per block)
+    float noise_db;
+    bool  seeded;       // noise_db holds a measurement
+    float noise_fall;
+    float noise_rise;
+    float smooth;
+
+    // last features
+    float power;        // smoothed mean square
+    float energy_db;
+    float zcr;          // crossings per sample
+    float flatness;     // 0 = tonal .. 1 = flat
+    float band_ratio;   // 250 Hz - 4 kHz share of the spectrum
+    float last_x;
+
+    // output
+    float prob;
+    vad_state_t state;
+    int counter;
+    volatile bool speech;
+} vad_t;
+
+void vad_init(vad_t *v, float fs, int block_size, float hangover_ms);
+void vad_set_sample_rate(vad_t *v, float fs);     // keeps the learned noise floor
+
+// Spectral features, call whenever new FFT bands (dB) of the signal that
+// vad_process_block() sees are available
+void vad_update_spectrum(vad_t *v, const float *bands_db);
+
+// Time-domain features + decision, once per block
+bool vad_process_block(vad_t *v, const float *x, int n);
+
+const char *vad_state_to_str(vad_state_t s);
+
+#endif // VAD_H
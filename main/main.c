@@ -1,3 +1,4 @@
+#include <string.h>
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -13,45 +14,123 @@
 #include "limiter.h"
 #include "compressor.h"
 #include "expander.h"
+#include "dyn_eq.h"
 #include "fft.h"
+#include "meter.h"
+#include "vad.h"
+#include "pipeline.h"
+#include "capture.h"
+#include "audio_tap.h"
+#include "monitor_stream.h"
+#include "pitch_tracker.h"
+#include "cache_stress.h"
+#include "subscription.h"
+#include "dsp_attr.h"
+#include "dsp_math.h"
+#include "dsp_kernels.h"
+#include "trace.h"
 
 extern volatile bool filter_enabled;
 rms_filter_t rms_in, rms_out;
 limiter_t limiter;
 compressor_t comp;
 expander_t expd;
+dyn_eq_t dyneq;
 eq_band_t hpf;
+meter_t meter;
+vad_t vad;
+pipeline_t pipeline;
+capture_t capture;
+audio_tap_t audio_tap;
+_Static_assert(I2S_BLOCK <= AUDIO_TAP_WRITE_MAX, "tap readers keep AUDIO_TAP_WRITE_MAX of margin");
+monitor_t monitor;
+pitch_tracker_t pitch_tracker;
+param_mailbox_t params;
 
 dsp_context_t dsp_ctx = {
     .expd = &expd,
     .comp = &comp,
     .limiter = &limiter,
-    .rms_out = &rms_out
+    .rms_out = &rms_out,
+    .dyneq = &dyneq,
+    .meter = &meter,
+    .vad = &vad,
+    .pipeline = &pipeline,
+    .capture = &capture,
+    .monitor = &monitor,
+    .pitch = &pitch_tracker,
+    .params = &params,
+    .sample_rate = I2S_SR_DEFAULT,
+    .block_budget_us = I2S_BLOCK * 1000000ULL / I2S_SR_DEFAULT
 };
 
-static void i2s_loopback_task(void *arg)
+// Audio task, between two blocks: new I2S clock, then every rate-dependent
+// coefficient (stored parameter values are re-applied at the new rate)
+static void switch_sample_rate(dsp_context_t *ctx, uint32_t fs)
+{
+    if (i2s_set_sample_rate(fs) != ESP_OK) {
+        ESP_LOGE(TAG, "RATE %lu failed", (unsigned long)fs);
+        return;
+    }
+
+    eq_set_sample_rate(fs);
+    rms_set_sample_rate(ctx->rms_out, fs);
+    param_registry_set_sample_rate(fs);
+    meter_set_sample_rate(ctx->meter, fs);
+    vad_set_sample_rate(ctx->vad, fs);
+    pipeline_set_sample_rate(ctx->pipeline, fs);
+    fft_set_sample_rate(fs);
+
+    // core 0 readers of the tap restart at the new rate from here, so a
+    // RATE reply that timed out cannot leave them behind
+    monitor_set_input_rate(ctx->monitor, fs);
+    pitch_tracker_set_input_rate(ctx->pitch, fs);
+    capture_set_sample_rate(ctx->capture, fs);
+
+    ctx->sample_rate = fs;
+    ctx->block_budget_us = I2S_BLOCK * 1000000ULL / fs;
+}
+
+static DSP_HOT void i2s_loopback_task(void *arg)
 {
     dsp_context_t *ctx = (dsp_context_t *)arg;  // access to dsp context
     i2s_chan_handle_t rx_chan = get_rx_channel();
     i2s_chan_handle_t tx_chan = get_tx_channel();
 
-    int32_t rx_buf[128];
-    int16_t tx_buf[128];
+    int32_t rx_buf[I2S_BLOCK];
+    int16_t tx_buf[I2S_BLOCK];
+    float in_blk[I2S_BLOCK];   // pre-DSP samples for metering
+    float out_blk[I2S_BLOCK];  // pipeline buffer, post-DSP samples for metering
     size_t bytes_read, bytes_written;
     static int block_count = 0;
     int64_t t_proc_start =0;
-    float level =0;
-    static float fft_buf[FFT_SIZE];
+    static float fft_buf[FFT_SIZE];     // post-DSP, SPECTRUM telemetry
+    static float vad_buf[FFT_SIZE];     // pre-DSP, VAD spectral features
+    static float vad_bands[VAD_BANDS];
     static int fft_idx = 0;
+    static unsigned spec_frame = 0, vad_frame = 0;
+    unsigned meter_hz = 0;
 
     for (;;)
     { 
+        uint32_t req = ctx->rate_request;
+        if (req) {
+            ctx->rate_request = 0;
+            switch_sample_rate(ctx, req);
+            fft_idx = 0;
+        }
 
         //int64_t t_start = esp_timer_get_time(); // calculate DSP + DMA perf
       
-        if (i2s_channel_read(rx_chan, rx_buf, sizeof(rx_buf), &bytes_read, portMAX_DELAY) == ESP_OK)
+        TRACE_BEGIN(TRACE_I2S_READ);
+        esp_err_t rx_err = i2s_channel_read(rx_chan, rx_buf, sizeof(rx_buf), &bytes_read, portMAX_DELAY);
+        TRACE_END(TRACE_I2S_READ);
+
+        if (rx_err == ESP_OK)
         {
             int samples = bytes_read / sizeof(int32_t);
+            int64_t t_block = esp_timer_get_time();
+            uint32_t clips = ctx->meter->in_clips + ctx->meter->out_clips;
 
             // calculate DSP perf
             /*
@@ -61,41 +140,92 @@ static void i2s_loopback_task(void *arg)
             }
             */
 
+            dsp_s24_to_f32(rx_buf, in_blk, samples, 3.0f / 8388608.0f); // with x3 pre-gain
+            memcpy(out_blk, in_blk, samples * sizeof(float));
+
+            // parameter updates from the UART land here, one batch per block
+            param_mailbox_apply(ctx->params);
+
+            // --- DSP Pipeline (stage order/bypass from the active descriptor) ---
+            TRACE_BEGIN(TRACE_PIPELINE);
+            pipeline_process(ctx->pipeline, out_blk, samples, filter_enabled);
+            TRACE_END(TRACE_PIPELINE);
+
+            // FFT frames: the output spectrum at the subscribed rate, the input one at
+            // VAD_SPECTRUM_HZ; in silence both make do with VAD_SILENCE_DIV times fewer
+            unsigned frames_per_s = ctx->sample_rate / FFT_SIZE;
+            unsigned spec_hz = sub_rate(SUB_SPECTRUM);
+            unsigned vad_hz = VAD_SPECTRUM_HZ;
+            if (!ctx->vad->speech) {
+                spec_hz = (spec_hz + VAD_SILENCE_DIV - 1) / VAD_SILENCE_DIV;
+                vad_hz  = (vad_hz + VAD_SILENCE_DIV - 1) / VAD_SILENCE_DIV;
+            }
+            unsigned spec_div = (spec_hz && spec_hz < frames_per_s) ? frames_per_s / spec_hz : 1;
+            unsigned vad_div  = (vad_hz < frames_per_s) ? frames_per_s / vad_hz : 1;
+
+            dsp_f32_to_s16(out_blk, tx_buf, samples);
+
+            // the VAD's time-domain features come from in_blk, so do its bands: the
+            // expander it keys would otherwise pull its own input towards silence
             for (int i = 0; i < samples; i++)
             {
-                
-                float x = (float)(rx_buf[i] >> 8) / 8388608.0f;
-                
-                x *= 3.0f; // pre-grain
-                
-                if (!filter_enabled) {
-                    // === BYPASS TOTAL ===
-                    float y = x;                           
-                    if (y > 1.0f) y = 1.0f;
-                    if (y < -1.0f) y = -1.0f;
-                    tx_buf[i] = (int16_t)(y * 32767.0f);                    
-                }
-                else{
-                    
-                    // --- DSP Pipeline  ---
-                    float y = eq3band_process(x);
-                    level = rms_process(ctx->rms_out, y);
-                    y = expander_process(ctx->expd, y, level);
-                    y = compressor_process(ctx->comp, y, level);
-                    y = limiter_process(ctx->limiter, y, level);
-
-                    y = tanhf(y); // soft clip
-
-                    fft_buf[fft_idx++] = y;
-                    if (fft_idx >= FFT_SIZE) {
+                fft_buf[fft_idx] = dsp_clampf(out_blk[i], -1.0f, 1.0f);
+                vad_buf[fft_idx] = in_blk[i];
+                if (++fft_idx >= FFT_SIZE) {
+                    fft_idx = 0;
+                    if (spec_hz && ++spec_frame >= spec_div) {
+                        spec_frame = 0;
+                        TRACE_BEGIN(TRACE_FFT);
                         analyze_fft_and_send(fft_buf);
-                        fft_idx = 0;
+                        TRACE_END(TRACE_FFT);
+                    }
+                    if (++vad_frame >= vad_div) {
+                        vad_frame = 0;
+                        TRACE_BEGIN(TRACE_FFT);
+                        fft_bands(vad_buf, vad_bands);
+                        vad_update_spectrum(ctx->vad, vad_bands);
+                        TRACE_END(TRACE_FFT);
                     }
-
-                    tx_buf[i] = (int16_t)(y * 32767.0f);
-                
                 }
             }
+
+            // post-DSP tap for core 0 consumers (monitor stream)
+            audio_tap_write(&audio_tap, tx_buf, samples);
+
+            // block-rate metering while subscribed, one window per telemetry period;
+            // clips are always counted for the capture trigger
+            unsigned hz = sub_rate(SUB_METERS);
+            if (hz != meter_hz) {
+                meter_hz = hz;
+                if (hz) meter_set_window(ctx->meter, 1000.0f / hz);
+            }
+            TRACE_BEGIN(TRACE_METER);
+            if (meter_hz)
+                meter_process_block(ctx->meter, in_blk, out_blk, samples,
+                                    ctx->expd->gain, ctx->comp->gain, ctx->limiter->gain);
+            else
+                meter_count_clips(ctx->meter, in_blk, out_blk, samples);
+            TRACE_END(TRACE_METER);
+
+            // voice activity keys the expander for the next block
+            TRACE_BEGIN(TRACE_VAD);
+            ctx->expd->key_open = vad_process_block(ctx->vad, in_blk, samples);
+            TRACE_END(TRACE_VAD);
+
+            // recorder taps: raw input and processed output, with trigger events
+            uint8_t events = 0;
+            if (ctx->meter->in_clips + ctx->meter->out_clips != clips)
+                events |= CAPTURE_TRIG_CLIP;
+            uint32_t dt = (uint32_t)(esp_timer_get_time() - t_block);
+            ctx->block_us = dt;
+            if (dt > ctx->block_us_max) ctx->block_us_max = dt;
+            if ((int64_t)dt * ctx->sample_rate > (int64_t)samples * 1000000) {
+                events |= CAPTURE_TRIG_DEADLINE;
+                ctx->overruns++;
+            }
+            TRACE_BEGIN(TRACE_CAPTURE);
+            capture_push(ctx->capture, rx_buf, tx_buf, samples, events);
+            TRACE_END(TRACE_CAPTURE);
             
               
             // calculate DSP perf 
@@ -108,7 +238,9 @@ static void i2s_loopback_task(void *arg)
             }
             */
 
+            TRACE_BEGIN(TRACE_I2S_WRITE);
             i2s_channel_write(tx_chan, tx_buf, samples * sizeof(int16_t), &bytes_written, portMAX_DELAY);
+            TRACE_END(TRACE_I2S_WRITE);
             
             // calculate DSP + DMA perf
             /*
@@ -124,19 +256,55 @@ void app_main(void)
 {
     ESP_LOGI(TAG, "Starting microphone → amplifier loopback with IIR filter...");
 
-    i2s_init_rx();
-    i2s_init_tx();
-    eq_init();
-    rms_init(&rms_out, I2S_SR, 20.0f);
+    i2s_init_rx(I2S_SR_DEFAULT);
+    i2s_init_tx(I2S_SR_DEFAULT);
+    eq_init(I2S_SR_DEFAULT);
+    rms_init(&rms_out, I2S_SR_DEFAULT, 20.0f);
     uart_interface_init();
-    limiter_init(&limiter, I2S_SR, 0.6f, 3.0f, 150.0f);
-    compressor_init(&comp, I2S_SR, 0.3f, 4.0f, 4.0f, 10.0f, 120.0f, 6.0f);  
-    expander_init(&expd, I2S_SR, 0.02f, 2.0f, 5.0f, 100.0f, 100.0f);   
-    fft_init();
+    limiter_init(&limiter, I2S_SR_DEFAULT, 0.6f, 3.0f, 150.0f);
+    compressor_init(&comp, I2S_SR_DEFAULT, 0.3f, 4.0f, 4.0f, 10.0f, 120.0f, 6.0f);  
+    expander_init(&expd, I2S_SR_DEFAULT, 0.02f, 2.0f, 5.0f, 100.0f, 100.0f);   
+    dyn_eq_init(&dyneq, I2S_SR_DEFAULT);
+    if (fft_init(I2S_SR_DEFAULT) != ESP_OK) ESP_LOGE(TAG, "FFT init failed");
+    param_registry_init(I2S_SR_DEFAULT, &expd, &comp, &limiter, &dyneq);    // defaults override the init values above
+    meter_init(&meter, I2S_SR_DEFAULT, I2S_BLOCK, 100.0f);
+    vad_init(&vad, I2S_SR_DEFAULT, I2S_BLOCK, 300.0f);
+
+    pipeline_init(&pipeline, I2S_SR_DEFAULT, 10.0f);
+    pipeline_bind(&pipeline, STAGE_DYNEQ, &dyneq);
+    pipeline_bind(&pipeline, STAGE_RMS, &rms_out);
+    pipeline_bind(&pipeline, STAGE_EXPANDER, &expd);
+    pipeline_bind(&pipeline, STAGE_COMPRESSOR, &comp);
+    pipeline_bind(&pipeline, STAGE_LIMITER, &limiter);
+
+    param_mailbox_init(&params);
+    sub_init();
+    audio_tap_init(&audio_tap);
+    monitor_init(&monitor, &audio_tap, I2S_SR_DEFAULT);
+    pitch_tracker_init(&pitch_tracker, &audio_tap, I2S_SR_DEFAULT);
+
+    if (capture_init(&capture, I2S_SR_DEFAULT, 0.25f) == ESP_OK)
+        capture_arm(&capture, CAPTURE_TRIG_MANUAL | CAPTURE_TRIG_DEADLINE);
 
+#if CONFIG_AUDIO_HOT_IRAM
+    // stack in internal DRAM regardless of the SPIRAM stack options
+    static StackType_t i2s_stack[8192 / sizeof(StackType_t)];
+    static StaticTask_t i2s_tcb;
+    xTaskCreateStaticPinnedToCore(i2s_loopback_task, "i2s", sizeof(i2s_stack), &dsp_ctx, 10,
+                                  i2s_stack, &i2s_tcb, 1); // core 1
+#else
     xTaskCreatePinnedToCore(i2s_loopback_task, "i2s", 8192, &dsp_ctx, 10, NULL, 1); // core 1
+#endif
+    xTaskCreatePinnedToCore(uart_tx_task, "uart_tx", 3072, NULL, 7, NULL, 0); // core 0
     xTaskCreatePinnedToCore(uart_interface_task_ui, "uart", 4096, &dsp_ctx, 5, NULL, 0); // core 0
     xTaskCreatePinnedToCore(switch_monitor_task, "sw", 2048, NULL, 3, NULL, 0); // core 0
     xTaskCreatePinnedToCore(telemetry_task, "telemetry", 4096, &dsp_ctx, 6, NULL, 0);
+    xTaskCreatePinnedToCore(monitor_task, "monitor", 4096, &monitor, 4, NULL, 0);
+    xTaskCreatePinnedToCore(pitch_tracker_task, "pitch", 4096, &pitch_tracker, 3, NULL, 0);
+    if (capture.ring)
+        xTaskCreatePinnedToCore(capture_task, "capture", 4096, &capture, 4, NULL, 0);
+#if CONFIG_AUDIO_CACHE_STRESS
+    xTaskCreatePinnedToCore(cache_stress_task, "stress", 2048, NULL, 1, NULL, 0);
+#endif
 
 }
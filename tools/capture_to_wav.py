@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""Rebuild WAV files from a capture dump (CAPTURE DUMP).
+
+Reads the framed binary dump either live from the serial port or from a
+file saved earlier, and writes <prefix>_pre.wav (raw mic input, 24-bit)
+and <prefix>_post.wav (DSP output, 16-bit).
+
+    python capture_to_wav.py --port /dev/ttyUSB0 --dump-baud 921600 -o bug42
+    python capture_to_wav.py --file dump.bin -o bug42
+
+Frame: A5 5A | type | len (u16 LE) | payload | crc16-ccitt (u16 LE).
+Text lines (telemetry, replies) between frames are skipped.
+"""
+import argparse
+import struct
+import sys
+import time
+import wave
+
+FRAME_HEADER = 0x01
+FRAME_BLOCK = 0x02
+FRAME_END = 0x03
+
+TRIGGERS = {0x01: "manual", 0x02: "clip", 0x04: "deadline"}
+
+
+def crc16_ccitt(data, crc=0xFFFF):
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+class FrameParser:
+    """Incremental parser, feed() bytes and get (type, payload) tuples back."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.bad_crc = 0
+
+    def feed(self, data):
+        self.buf += data
+        frames = []
+        while True:
+            start = self.buf.find(b"\xA5\x5A")
+            if start < 0:
+                del self.buf[:-1]
+                return frames
+            del self.buf[:start]
+            if len(self.buf) < 5:
+                return frames
+            ftype = self.buf[2]
+            length = self.buf[3] | (self.buf[4] << 8)
+            if len(self.buf) < 5 + length + 2:
+                return frames
+            payload = bytes(self.buf[5:5 + length])
+            crc = self.buf[5 + length] | (self.buf[6 + length] << 8)
+            if crc16_ccitt(self.buf[2:5 + length]) == crc:
+                frames.append((ftype, payload))
+                del self.buf[:7 + length]
+            else:
+                self.bad_crc += 1
+                del self.buf[:2]            # false sync, resync after it
+
+
+def read_dump(source, parser):
+    header, blocks = None, []
+    for chunk in source:
+        for ftype, payload in parser.feed(chunk):
+            if ftype == FRAME_HEADER:
+                ver, fs, block, count, trig, reason, dropped = struct.unpack_from("<BIHIIBI", payload)
+                header = dict(version=ver, fs=fs, block=block, count=count,
+                              trigger=None if trig == 0xFFFFFFFF else trig,
+                              reason=reason, dropped=dropped)
+                blocks = []
+                print(f"header: {count} blocks of {block} @ {fs} Hz", file=sys.stderr)
+            elif ftype == FRAME_BLOCK and header:
+                seq, events, n = struct.unpack_from("<IBH", payload)
+                pre = payload[7:7 + 3 * n]
+                post = payload[7 + 3 * n:7 + 5 * n]
+                blocks.append((seq, events, pre, post))
+                if len(blocks) % 200 == 0:
+                    print(f"  {len(blocks)}/{header['count']}", file=sys.stderr)
+            elif ftype == FRAME_END and header:
+                return header, blocks
+    return header, blocks
+
+
+def serial_source(port, baud, dump_baud, timeout):
+    import serial
+    ser = serial.Serial(port, baud, timeout=0.2)
+    ser.reset_input_buffer()
+    cmd = f"CAPTURE DUMP {dump_baud}\n" if dump_baud else "CAPTURE DUMP\n"
+    ser.write(cmd.encode())
+
+    if dump_baud:
+        # wait for the device to announce the switch, then follow it
+        line = b""
+        deadline = time.time() + 5
+        while b"CAPTURE:BAUD=" not in line and time.time() < deadline:
+            line = ser.readline()
+        ser.baudrate = dump_baud
+
+    last = time.time()
+    try:
+        while time.time() - last < timeout:
+            data = ser.read(4096)
+            if data:
+                last = time.time()
+                yield data
+    finally:
+        if dump_baud:
+            ser.baudrate = baud
+        ser.close()
+
+
+def file_source(path):
+    with open(path, "rb") as f:
+        while True:
+            data = f.read(65536)
+            if not data:
+                return
+            yield data
+
+
+def write_wavs(prefix, header, blocks):
+    pre = bytearray()
+    post = bytearray()
+    for _, _, p, q in blocks:
+        pre += p
+        post += q
+
+    with wave.open(f"{prefix}_pre.wav", "wb") as w:
+        w.setnchannels(1)
+        w.setsampwidth(3)
+        w.setframerate(header["fs"])
+        w.writeframes(bytes(pre))
+
+    with wave.open(f"{prefix}_post.wav", "wb") as w:
+        w.setnchannels(1)
+        w.setsampwidth(2)
+        w.setframerate(header["fs"])
+        w.writeframes(bytes(post))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    src = ap.add_mutually_exclusive_group(required=True)
+    src.add_argument("--port", help="serial port, sends CAPTURE DUMP itself")
+    src.add_argument("--file", help="raw dump saved from the serial port")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--dump-baud", type=int, default=0, help="ask the device to dump at this rate")
+    ap.add_argument("--timeout", type=float, default=3.0, help="seconds of silence that end the dump")
+    ap.add_argument("-o", "--output", default="capture", help="output file prefix")
+    args = ap.parse_args()
+
+    parser = FrameParser()
+    source = serial_source(args.port, args.baud, args.dump_baud, args.timeout) if args.port else file_source(args.file)
+    header, blocks = read_dump(source, parser)
+
+    if not header:
+        sys.exit("no capture header found")
+    if len(blocks) != header["count"]:
+        print(f"warning: got {len(blocks)} of {header['count']} blocks", file=sys.stderr)
+    seqs = [b[0] for b in blocks]
+    gaps = sum(1 for a, b in zip(seqs, seqs[1:]) if b != a + 1)
+
+    write_wavs(args.output, header, blocks)
+
+    fs, n = header["fs"], header["block"]
+    print(f"{len(blocks)} blocks, {len(blocks) * n / fs:.2f} s -> {args.output}_pre.wav, {args.output}_post.wav")
+    if header["trigger"] is not None:
+        reason = TRIGGERS.get(header["reason"], hex(header["reason"]))
+        print(f"trigger: {reason} at {header['trigger'] * n / fs:.3f} s")
+    events = [(i, e) for i, (_, e, _, _) in enumerate(blocks) if e]
+    for i, e in events[:20]:
+        names = ",".join(v for k, v in TRIGGERS.items() if e & k)
+        print(f"  event {names} at {i * n / fs:.3f} s")
+    print(f"sequence gaps: {gaps}, dropped in staging: {header['dropped']}, bad frames: {parser.bad_crc}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,581 @@
+// Host golden-reference regression suite for the DSP kernels: every module
+// against a straightforward double-precision reference, plus stored output
+// vectors of the block kernels so an optimised version can be diffed
+// automatically.
+//
+// Build:  gcc -O2 -Imain/dsp -Icomponents/sim/include -Itools/host tools/dsp_eval.c
+//             main/dsp/biquad.c main/dsp/compressor.c main/dsp/expander.c main/dsp/limiter.c
+//             main/dsp/rms.c main/dsp/fft.c main/dsp/dsp_kernels_ref.c main/dsp/dsp_kernels_x86.c
+//             components/sim/sim_dsp.c -lm -o dsp_eval
+// Usage:  ./dsp_eval [-g tools/golden] [-w] [-v]
+//
+// -w rewrites the golden vectors from the current build (after a change
+// that is meant to alter the sound), -v prints every measurement. Each
+// check has its own tolerance; the exit status is the number of failures.
+//
+// Checks:
+//   math     dsp_math.h log2 / exp2 / tanh vs libm in double
+//   rbj      |H(f)| of biquad_design() vs the cookbook formulas in double
+//   stable   is_biquad_stable() vs the pole radius, and no unstable design
+//   comp     compressor static curve through the knee, attack / release
+//   exp      expander static curve, attack / release
+//   limit    limiter static curve, attack / release
+//   rms      RMS detector time constant
+//   fft      band energy of analyze_fft_and_send() on tones vs a direct DFT
+//   golden   EQ -> RMS -> expander -> compressor -> limiter on a fixed
+//            stimulus, and the FFT bands, vs tools/golden/*.txt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+#include "biquad.h"
+#include "iir_filter.h"
+#include "compressor.h"
+#include "expander.h"
+#include "limiter.h"
+#include "rms.h"
+#include "fft.h"
+#include "dsp_math.h"
+
+#define GOLDEN_FS     16000
+#define GOLDEN_N      2048
+#define BLOCK         128
+
+static int verbose;
+static int failures;
+
+// One line per check: worst error against its tolerance budget
+static void report(const char *name, double err, double tol, const char *unit)
+{
+    int ok = err <= tol;
+    if (!ok) failures++;
+    printf("%-34s err=%10.3g %-7s tol=%8.3g  %s\n", name, err, unit, tol, ok ? "ok" : "FAIL");
+}
+
+static double db(double x)
+{
+    return 20.0 * log10(fmax(x, 1e-30));
+}
+
+// ---------------- inline math ----------------
+
+static void check_math(void)
+{
+    double worst = 0.0;
+    for (double x = 1e-9; x < 1e4; x *= 1.0009)
+        worst = fmax(worst, fabs(dsp_log2f((float)x) - log2((float)x)));
+    report("math dsp_log2f 1e-9..1e4", worst, 4e-6, "abs");     // 1 ulp at |log2| ~ 30
+
+    worst = 0.0;
+    for (double x = -120.0; x <= 120.0; x += 0.0037) {
+        double r = exp2((float)x);
+        worst = fmax(worst, fabs(dsp_exp2f((float)x) - r) / r);
+    }
+    report("math dsp_exp2f -120..120", worst, 1e-6, "rel");
+
+    worst = 0.0;
+    for (double x = -12.0; x <= 12.0; x += 0.0011)
+        worst = fmax(worst, fabs(dsp_tanhf((float)x) - tanh((float)x)));
+    report("math dsp_tanhf -12..12", worst, 1e-6, "abs");
+}
+
+// ---------------- RBJ response ----------------
+
+// Cookbook coefficients in double, normalised to a0 = 1
+static void rbj_ref(filter_type_t type, double fc, double Q, double gain_db, double fs, double c[5])
+{
+    double w0 = 2.0 * M_PI * fc / fs, cw = cos(w0), sw = sin(w0);
+    double alpha = sw / (2.0 * Q), A = pow(10.0, gain_db / 40.0), sA = sqrt(A);
+    double b0, b1, b2, a0, a1, a2;
+
+    switch (type) {
+    case FILTER_LOW_PASS:
+        b0 = (1 - cw) / 2; b1 = 1 - cw; b2 = (1 - cw) / 2;
+        a0 = 1 + alpha; a1 = -2 * cw; a2 = 1 - alpha;
+        break;
+    case FILTER_HIGH_PASS:
+        b0 = (1 + cw) / 2; b1 = -(1 + cw); b2 = (1 + cw) / 2;
+        a0 = 1 + alpha; a1 = -2 * cw; a2 = 1 - alpha;
+        break;
+    case FILTER_BAND_PASS:          // constant 0 dB peak gain
+        b0 = alpha; b1 = 0; b2 = -alpha;
+        a0 = 1 + alpha; a1 = -2 * cw; a2 = 1 - alpha;
+        break;
+    case FILTER_PEAKING:
+        b0 = 1 + alpha * A; b1 = -2 * cw; b2 = 1 - alpha * A;
+        a0 = 1 + alpha / A; a1 = -2 * cw; a2 = 1 - alpha / A;
+        break;
+    case FILTER_LOW_SHELF:
+        b0 = A * ((A + 1) - (A - 1) * cw + 2 * sA * alpha);
+        b1 = 2 * A * ((A - 1) - (A + 1) * cw);
+        b2 = A * ((A + 1) - (A - 1) * cw - 2 * sA * alpha);
+        a0 = (A + 1) + (A - 1) * cw + 2 * sA * alpha;
+        a1 = -2 * ((A - 1) + (A + 1) * cw);
+        a2 = (A + 1) + (A - 1) * cw - 2 * sA * alpha;
+        break;
+    default:                        // FILTER_HIGH_SHELF
+        b0 = A * ((A + 1) + (A - 1) * cw + 2 * sA * alpha);
+        b1 = -2 * A * ((A - 1) + (A + 1) * cw);
+        b2 = A * ((A + 1) + (A - 1) * cw - 2 * sA * alpha);
+        a0 = (A + 1) - (A - 1) * cw + 2 * sA * alpha;
+        a1 = 2 * ((A - 1) - (A + 1) * cw);
+        a2 = (A + 1) - (A - 1) * cw - 2 * sA * alpha;
+        break;
+    }
+    c[0] = b0 / a0; c[1] = b1 / a0; c[2] = b2 / a0; c[3] = a1 / a0; c[4] = a2 / a0;
+}
+
+static double mag_db(const double c[5], double f, double fs)
+{
+    double complex z = cexp(-I * 2.0 * M_PI * f / fs);
+    double complex h = (c[0] + c[1] * z + c[2] * z * z) / (1.0 + c[3] * z + c[4] * z * z);
+    return db(cabs(h));
+}
+
+static void check_rbj(void)
+{
+    static const char *const names[] = { "LP", "HP", "BP", "PEAK", "LSHELF", "HSHELF" };
+    static const struct { double fc, Q, gain; } cases[] = {
+        { 80, 0.707, 6 }, { 250, 1.0, -9 }, { 1000, 0.5, 12 }, { 3000, 2.0, -12 }, { 8000, 0.9, 4 },
+    };
+    const double fs = 48000.0;
+
+    for (int t = FILTER_LOW_PASS; t <= FILTER_HIGH_SHELF; t++) {
+        double worst = 0.0;
+        for (size_t k = 0; k < sizeof(cases) / sizeof(cases[0]); k++) {
+            biquad_coeffs_t bc;
+            double ref[5];
+            if (!biquad_design((filter_type_t)t, (float)cases[k].fc, (float)cases[k].Q,
+                               (float)cases[k].gain, (float)fs, &bc)) {
+                worst = INFINITY;
+                continue;
+            }
+            double got[5] = { bc.b0, bc.b1, bc.b2, bc.a1, bc.a2 };
+            rbj_ref((filter_type_t)t, cases[k].fc, cases[k].Q, cases[k].gain, fs, ref);
+
+            // 20 Hz .. 20 kHz, skipping the stop-band floor where dB error is meaningless
+            for (int i = 0; i <= 96; i++) {
+                double f = 20.0 * pow(1000.0, i / 96.0);
+                double r = mag_db(ref, f, fs);
+                if (r < -60.0) continue;
+                worst = fmax(worst, fabs(mag_db(got, f, fs) - r));
+            }
+        }
+        char name[40];
+        snprintf(name, sizeof(name), "rbj %s |H| 20 Hz-20 kHz", names[t]);
+        report(name, worst, 0.02, "dB");
+    }
+}
+
+// ---------------- stability ----------------
+
+// Reference: both poles of z^2 + a1 z + a2 inside the unit circle
+static int stable_ref(double a1, double a2, double *margin)
+{
+    double complex d = csqrt(a1 * a1 - 4.0 * a2 + 0.0 * I);
+    double r = fmax(cabs((-a1 + d) / 2.0), cabs((-a1 - d) / 2.0));
+    *margin = fabs(1.0 - r);
+    return r < 1.0;
+}
+
+static void check_stability(void)
+{
+    long wrong = 0, points = 0;
+    for (int i = 0; i <= 400; i++) {
+        for (int j = 0; j <= 300; j++) {
+            double a1 = -2.5 + 5.0 * i / 400.0, a2 = -1.5 + 3.0 * j / 300.0, margin;
+            int ref = stable_ref(a1, a2, &margin);
+            if (margin < 1e-4) continue;            // on the boundary, float rounding decides
+            points++;
+            if (ref != (int)is_biquad_stable((float)a1, (float)a2)) {
+                if (verbose) printf("  stability: a1=%.4f a2=%.4f ref=%d\n", a1, a2, ref);
+                wrong++;
+            }
+        }
+    }
+    report("stable is_biquad_stable grid", (double)wrong, 0, "points");
+
+    // a design that returns true must be stable, also at silly settings
+    long bad = 0;
+    for (int t = FILTER_LOW_PASS; t <= FILTER_HIGH_SHELF; t++) {
+        for (double fc = 5.0; fc < 30000.0; fc *= 1.37) {
+            for (double Q = 0.01; Q < 200.0; Q *= 3.1) {
+                biquad_coeffs_t bc;
+                double margin;
+                if (biquad_design((filter_type_t)t, (float)fc, (float)Q, 18.0f, 48000.0f, &bc) &&
+                    !stable_ref(bc.a1, bc.a2, &margin) && margin >= 1e-6)
+                    bad++;
+            }
+        }
+    }
+    report("stable biquad_design accepts", (double)bad, 0, "unstable");
+}
+
+// ---------------- dynamics ----------------
+
+// Settled gain in dB for a constant detector level: x is a small probe so
+// the compressor's output clip never engages
+typedef float (*dyn_fn_t)(void *state, float x, float level);
+
+static float comp_fn(void *s, float x, float l)  { return compressor_process((compressor_t *)s, x, l); }
+static float exp_fn(void *s, float x, float l)   { return expander_process((expander_t *)s, x, l); }
+static float limit_fn(void *s, float x, float l) { return limiter_process((limiter_t *)s, x, l); }
+
+static double settled_gain_db(dyn_fn_t fn, void *state, float level, int samples)
+{
+    const float probe = 1e-3f;
+    float y = 0.0f;
+    for (int i = 0; i < samples; i++) y = fn(state, probe, level);
+    return db(y / probe);
+}
+
+// Samples for the gain to cover 1 - 1/e of a step from its settled value
+// at level_a to the one at level_b
+static double step_tau(dyn_fn_t fn, void *state, float *gain, float level_a, float level_b, int settle)
+{
+    const float probe = 1e-3f;
+    for (int i = 0; i < settle; i++) fn(state, probe, level_a);
+    double g0 = *gain;
+    for (int i = 0; i < settle; i++) fn(state, probe, level_b);
+    double g1 = *gain;
+    for (int i = 0; i < settle; i++) fn(state, probe, level_a);
+
+    double target = g0 + (g1 - g0) * (1.0 - exp(-1.0));
+    double prev = *gain;
+    for (int i = 1; i <= settle; i++) {
+        fn(state, probe, level_b);
+        double g = *gain;
+        if ((g1 < g0) ? (g <= target) : (g >= target))
+            return (i - 1) + (prev - target) / (prev - g);     // linear between samples
+        prev = g;
+    }
+    return INFINITY;
+}
+
+// Reference static curves (dB in, gain dB out)
+static double comp_ref(double l, double t, double r, double w)
+{
+    if (l <= t - w / 2) return 0.0;
+    if (l >= t + w / 2) return (1.0 / r - 1.0) * (l - t);
+    double d = l - t + w / 2;
+    return (1.0 / r - 1.0) * d * d / (2.0 * w);
+}
+
+// Downward expander as the module defines it: below the threshold the gain
+// falls by (1 - 1/ratio) dB per dB
+static double exp_ref(double l, double t, double r)
+{
+    return (l < t) ? (1.0 - 1.0 / r) * (l - t) : 0.0;
+}
+
+static double limit_ref(double l, double t)
+{
+    return (l > t) ? t - l : 0.0;
+}
+
+static void check_dynamics(void)
+{
+    const float fs = 48000.0f;
+    const int settle = 48000 * 2;
+    double worst;
+
+    compressor_t c;
+    const double c_thr = 0.3, c_ratio = 4.0, c_knee = 6.0;
+    worst = 0.0;
+    for (double l = -40.0; l <= 0.0; l += 0.25) {
+        compressor_init(&c, fs, (float)c_thr, (float)c_ratio, 0.0f, 1.0f, 1.0f, (float)c_knee);
+        double got = settled_gain_db(comp_fn, &c, (float)pow(10.0, l / 20.0), 4800);
+        worst = fmax(worst, fabs(got - comp_ref(l, db(c_thr), c_ratio, c_knee)));
+    }
+    report("comp static curve + knee", worst, 0.01, "dB");
+
+    compressor_init(&c, fs, (float)c_thr, (float)c_ratio, 0.0f, 10.0f, 120.0f, (float)c_knee);
+    double tau = step_tau(comp_fn, &c, &c.gain, 0.01f, 1.0f, settle);
+    report("comp attack 10 ms", fabs(tau / (0.010 * fs) - 1.0), 0.005, "rel");
+    tau = step_tau(comp_fn, &c, &c.gain, 1.0f, 0.01f, settle);
+    report("comp release 120 ms", fabs(tau / (0.120 * fs) - 1.0), 0.005, "rel");
+
+    expander_t e;
+    const double e_thr = 0.02, e_ratio = 2.0;
+    worst = 0.0;
+    for (double l = -70.0; l <= -10.0; l += 0.25) {
+        expander_init(&e, fs, (float)e_thr, (float)e_ratio, 1.0f, 1.0f, 0.0f);
+        double got = settled_gain_db(exp_fn, &e, (float)pow(10.0, l / 20.0), 4800);
+        worst = fmax(worst, fabs(got - exp_ref(l, db(e_thr), e_ratio)));
+    }
+    report("exp static curve", worst, 0.01, "dB");
+
+    expander_init(&e, fs, (float)e_thr, (float)e_ratio, 5.0f, 100.0f, 0.0f);
+    tau = step_tau(exp_fn, &e, &e.gain, 0.1f, 0.002f, settle);
+    report("exp attack 5 ms", fabs(tau / (0.005 * fs) - 1.0), 0.005, "rel");
+    tau = step_tau(exp_fn, &e, &e.gain, 0.002f, 0.1f, settle);
+    report("exp release 100 ms", fabs(tau / (0.100 * fs) - 1.0), 0.005, "rel");
+
+    limiter_t lim;
+    const double l_thr = 0.6;
+    worst = 0.0;
+    for (double l = -20.0; l <= 12.0; l += 0.25) {
+        limiter_init(&lim, fs, (float)l_thr, 1.0f, 1.0f);
+        double got = settled_gain_db(limit_fn, &lim, (float)pow(10.0, l / 20.0), 4800);
+        worst = fmax(worst, fabs(got - limit_ref(l, db(l_thr))));
+    }
+    report("limit static curve", worst, 0.01, "dB");
+
+    limiter_init(&lim, fs, (float)l_thr, 3.0f, 150.0f);
+    tau = step_tau(limit_fn, &lim, &lim.gain, 0.1f, 2.0f, settle);
+    report("limit attack 3 ms", fabs(tau / (0.003 * fs) - 1.0), 0.005, "rel");
+    tau = step_tau(limit_fn, &lim, &lim.gain, 2.0f, 0.1f, settle);
+    report("limit release 150 ms", fabs(tau / (0.150 * fs) - 1.0), 0.005, "rel");
+
+    // RMS detector: mean square of a unit step reaches 1 - 1/e after tau
+    rms_filter_t r;
+    rms_init(&r, fs, 20.0f);
+    int n = 0;
+    while (r.rms_sq < 1.0 - exp(-1.0) && n < settle) { rms_process(&r, 1.0f); n++; }
+    report("rms tau 20 ms", fabs(n / (0.020 * fs) - 1.0), 0.002, "rel");
+}
+
+// ---------------- FFT bands ----------------
+
+static const double band_edges[9] = { 60, 120, 250, 500, 1000, 2000, 4000, 8000, 16000 };
+
+// Same windowing and band layout as fft.c, all in double with a direct DFT
+static void bands_ref(const float *x, double fs, double *bands)
+{
+    double win[FFT_SIZE], win_sum = 0.0;
+    for (int i = 0; i < FFT_SIZE; i++) {
+        win[i] = 0.5 - 0.5 * cos(2.0 * M_PI * i / (FFT_SIZE - 1));
+        win_sum += win[i];
+    }
+    double g = win_sum / FFT_SIZE;
+
+    for (int b = 0; b < 8; b++) {
+        int start = (int)(band_edges[b] * FFT_SIZE / fs);
+        int end   = (int)(band_edges[b + 1] * FFT_SIZE / fs);
+        if (start < 1) start = 1;
+        if (start > FFT_SIZE / 2 - 1) start = FFT_SIZE / 2 - 1;
+        if (end > FFT_SIZE / 2) end = FFT_SIZE / 2;
+        if (end <= start) end = start + 1;
+
+        double acc = 0.0;
+        for (int k = start; k < end; k++) {
+            double complex s = 0.0;
+            for (int i = 0; i < FFT_SIZE; i++)
+                s += x[i] * win[i] * cexp(-I * 2.0 * M_PI * k * i / FFT_SIZE);
+            acc += creal(s) * creal(s) + cimag(s) * cimag(s);
+        }
+        acc /= (end - start) * g * g;
+        bands[b] = 10.0 * log10(acc + 1e-12);
+    }
+}
+
+static void check_fft(void)
+{
+    static const double rates[] = { 16000, 48000 };
+    static const double tones[] = { 90, 180, 370, 740, 1500, 3000, 6000, 12000 };
+    float x[FFT_SIZE];
+
+    for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+        double fs = rates[r], worst = 0.0;
+        int misplaced = 0;
+        fft_init((float)fs);
+
+        for (size_t t = 0; t < sizeof(tones) / sizeof(tones[0]); t++) {
+            if (tones[t] >= fs / 2) continue;
+            for (int i = 0; i < FFT_SIZE; i++)
+                x[i] = (float)(0.5 * sin(2.0 * M_PI * tones[t] * i / fs + 0.3));
+            double ref[8];
+            analyze_fft_and_send(x);
+            bands_ref(x, fs, ref);
+
+            int top = 0, top_ref = 0;
+            for (int b = 0; b < 8; b++) {
+                if (ref[b] > -60.0) worst = fmax(worst, fabs(fft_last_bands[b] - ref[b]));
+                if (fft_last_bands[b] > fft_last_bands[top]) top = b;
+                if (ref[b] > ref[top_ref]) top_ref = b;
+            }
+            if (top != top_ref) misplaced++;
+            if (verbose) printf("  fft %5.0f Hz @ %5.0f: band %d %.2f dB (ref %.2f)\n",
+                                tones[t], fs, top, fft_last_bands[top], ref[top_ref]);
+        }
+        char name[40];
+        snprintf(name, sizeof(name), "fft band energy, tones @ %.0f", fs);
+        report(name, worst, 0.05, "dB");
+        snprintf(name, sizeof(name), "fft loudest band, tones @ %.0f", fs);
+        report(name, misplaced, 0, "tones");
+    }
+}
+
+// ---------------- golden vectors ----------------
+
+#define GOLDEN_COLS  5          // eq, rms, expander, compressor, limiter
+
+static const char *const golden_names[GOLDEN_COLS] = { "eq", "rms", "expander", "compressor", "limiter" };
+static const double golden_tol[GOLDEN_COLS] = { 1e-5, 1e-5, 1e-5, 1e-5, 1e-5 };
+
+static uint32_t rng = 1;
+static float noise(void)
+{
+    rng = rng * 1664525u + 1013904223u;
+    return (float)((rng >> 8) * (1.0 / 16777216.0) * 2.0 - 1.0);
+}
+
+// Tone bursts and noise over a 60 dB range, so every stage moves
+static void golden_stimulus(float *x)
+{
+    for (int i = 0; i < GOLDEN_N; i++) {
+        double t = (double)i / GOLDEN_FS;
+        double env = (i < 512) ? 0.005 : (i < 1024) ? 0.9 : (i < 1536) ? 0.05 : 0.3;
+        x[i] = (float)(env * (0.6 * sin(2.0 * M_PI * 220.0 * t) + 0.3 * sin(2.0 * M_PI * 2900.0 * t))
+                       + 0.1 * env * noise());
+    }
+}
+
+static void eq_band_set(eq_band_t *b, filter_type_t type, float fc, float Q, float gain)
+{
+    biquad_coeffs_t c;
+    memset(b, 0, sizeof(*b));
+    biquad_design(type, fc, Q, gain, (float)GOLDEN_FS, &c);
+    b->b0 = c.b0; b->b1 = c.b1; b->b2 = c.b2; b->a1 = c.a1; b->a2 = c.a2;
+}
+
+// The audio chain in pipeline order, block by block, every stage recorded
+static void golden_run(float out[GOLDEN_COLS][GOLDEN_N], float bands[8])
+{
+    static float x[GOLDEN_N];
+    golden_stimulus(x);
+
+    eq3band_t eq;
+    eq_band_set(&eq.low, FILTER_LOW_SHELF, 120.0f, 0.707f, 4.0f);
+    eq_band_set(&eq.mid, FILTER_PEAKING, 1000.0f, 1.0f, -3.0f);
+    eq_band_set(&eq.high, FILTER_HIGH_SHELF, 6000.0f, 0.707f, 2.0f);
+    rms_filter_t r;
+    expander_t e;
+    compressor_t c;
+    limiter_t l;
+    rms_init(&r, GOLDEN_FS, 5.0f);
+    expander_init(&e, GOLDEN_FS, 0.02f, 2.0f, 2.0f, 20.0f, 10.0f);
+    compressor_init(&c, GOLDEN_FS, 0.3f, 4.0f, 4.0f, 2.0f, 30.0f, 6.0f);
+    limiter_init(&l, GOLDEN_FS, 0.6f, 1.0f, 30.0f);
+
+    float level[BLOCK];
+    for (int i = 0; i < GOLDEN_N; i += BLOCK) {
+        float *b = &x[i];
+        for (int k = 0; k < BLOCK; k++) b[k] = eq3band_process(&eq, b[k]);
+        memcpy(&out[0][i], b, sizeof(level));
+        rms_process_block(&r, b, level, BLOCK);
+        memcpy(&out[1][i], level, sizeof(level));
+        expander_process_block(&e, b, level, BLOCK);
+        memcpy(&out[2][i], b, sizeof(level));
+        compressor_process_block(&c, b, level, BLOCK);
+        memcpy(&out[3][i], b, sizeof(level));
+        limiter_process_block(&l, b, level, BLOCK);
+        memcpy(&out[4][i], b, sizeof(level));
+    }
+
+    fft_init((float)GOLDEN_FS);
+    analyze_fft_and_send(&out[4][GOLDEN_N - FFT_SIZE]);
+    memcpy(bands, fft_last_bands, 8 * sizeof(float));
+}
+
+static int golden_write(const char *dir, float out[GOLDEN_COLS][GOLDEN_N], const float *bands)
+{
+    char path[512];
+    snprintf(path, sizeof(path), "%s/chain.txt", dir);
+    FILE *f = fopen(path, "w");
+    if (!f) { perror(path); return -1; }
+    fprintf(f, "# dsp_eval golden vectors, %d Hz: eq rms expander compressor limiter\n", GOLDEN_FS);
+    for (int i = 0; i < GOLDEN_N; i++) {
+        for (int k = 0; k < GOLDEN_COLS; k++)
+            fprintf(f, "%s%.9g", k ? " " : "", out[k][i]);
+        fprintf(f, "\n");
+    }
+    fclose(f);
+
+    snprintf(path, sizeof(path), "%s/fft_bands.txt", dir);
+    f = fopen(path, "w");
+    if (!f) { perror(path); return -1; }
+    fprintf(f, "# dsp_eval golden vectors: FFT bands (dB) of the last limiter frame\n");
+    for (int b = 0; b < 8; b++) fprintf(f, "%.9g\n", bands[b]);
+    fclose(f);
+    printf("golden vectors written to %s\n", dir);
+    return 0;
+}
+
+static int read_values(const char *path, double *v, int max)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) { perror(path); return -1; }
+    char line[512];
+    int n = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#') continue;
+        char *p = line, *end;
+        for (double d = strtod(p, &end); end != p && n < max; d = strtod(p, &end)) {
+            v[n++] = d;
+            p = end;
+        }
+    }
+    fclose(f);
+    return n;
+}
+
+static void check_golden(const char *dir, float out[GOLDEN_COLS][GOLDEN_N], const float *bands)
+{
+    static double v[GOLDEN_COLS * GOLDEN_N];
+    char path[512];
+    snprintf(path, sizeof(path), "%s/chain.txt", dir);
+    if (read_values(path, v, GOLDEN_COLS * GOLDEN_N) != GOLDEN_COLS * GOLDEN_N) {
+        report("golden chain.txt readable", 1, 0, "files");
+        return;
+    }
+    for (int k = 0; k < GOLDEN_COLS; k++) {
+        double worst = 0.0;
+        for (int i = 0; i < GOLDEN_N; i++)
+            worst = fmax(worst, fabs(out[k][i] - v[i * GOLDEN_COLS + k]));
+        char name[40];
+        snprintf(name, sizeof(name), "golden %s", golden_names[k]);
+        report(name, worst, golden_tol[k], "abs");
+    }
+
+    snprintf(path, sizeof(path), "%s/fft_bands.txt", dir);
+    if (read_values(path, v, 8) != 8) {
+        report("golden fft_bands.txt readable", 1, 0, "files");
+        return;
+    }
+    double worst = 0.0;
+    for (int b = 0; b < 8; b++) worst = fmax(worst, fabs(bands[b] - v[b]));
+    report("golden fft bands", worst, 0.01, "dB");
+}
+
+int main(int argc, char **argv)
+{
+    const char *dir = "tools/golden";
+    int write = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-g") && i + 1 < argc) dir = argv[++i];
+        else if (!strcmp(argv[i], "-w")) write = 1;
+        else if (!strcmp(argv[i], "-v")) verbose = 1;
+        else {
+            fprintf(stderr, "usage: %s [-g golden_dir] [-w] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    static float out[GOLDEN_COLS][GOLDEN_N];
+    float bands[8];
+    golden_run(out, bands);
+    if (write) return golden_write(dir, out, bands) ? 1 : 0;
+
+    check_math();
+    check_rbj();
+    check_stability();
+    check_dynamics();
+    check_fft();
+    check_golden(dir, out, bands);
+
+    printf("%d failure%s\n", failures, failures == 1 ? "" : "s");
+    return failures;
+}
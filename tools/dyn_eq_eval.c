@@ -0,0 +1,68 @@
+// Host sweep of the dynamic EQ (main/dsp/dyn_eq.c): steady-state gain of a
+// sine at each frequency, with the de-esser band enabled.
+//
+// Build:  gcc -O2 -Imain/dsp tools/dyn_eq_eval.c main/dsp/dyn_eq.c main/dsp/biquad.c -lm -o dyn_eq_eval
+// Usage:  ./dyn_eq_eval [-l level_dbfs] [-f fs]
+//
+// A tone above the threshold inside 5-9 kHz should come out cut by up to
+// the range; tones outside the sidechain band should pass at ~0 dB.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "dyn_eq.h"
+
+#define BLOCK 128
+
+static double tone_gain_db(float fs, float level_db, float f)
+{
+    dyn_eq_t d;
+    dyn_eq_init(&d, fs);
+    d.band[0].enabled = true;
+    dyn_eq_update(&d);
+
+    float amp = powf(10.0f, level_db / 20.0f) * sqrtf(2.0f);    // level is RMS
+    float x[BLOCK];
+    long settle = (long)(0.5f * fs), total = settle + (long)(0.25f * fs);
+    double in_sq = 0.0, out_sq = 0.0;
+
+    for (long n = 0; n < total; n += BLOCK) {
+        for (int i = 0; i < BLOCK; i++)
+            x[i] = amp * sinf(2.0f * (float)M_PI * f * (float)(n + i) / fs);
+        float in[BLOCK];
+        memcpy(in, x, sizeof(in));
+        dyn_eq_process_block(&d, x, BLOCK);
+        if (n >= settle) {
+            for (int i = 0; i < BLOCK; i++) {
+                in_sq += (double)in[i] * in[i];
+                out_sq += (double)x[i] * x[i];
+            }
+        }
+    }
+    return 10.0 * log10(out_sq / in_sq);
+}
+
+int main(int argc, char **argv)
+{
+    float fs = 48000.0f, level = -20.0f;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "-l")) level = strtof(argv[i + 1], NULL);
+        else if (!strcmp(argv[i], "-f")) fs = strtof(argv[i + 1], NULL);
+        else { fprintf(stderr, "usage: %s [-l level_dbfs] [-f fs]\n", argv[0]); return 1; }
+    }
+
+    static const float freqs[] = { 100, 250, 500, 1000, 2000, 3000, 4000, 5000, 6000,
+                                   6700, 7500, 9000, 11000, 14000, 18000 };
+    dyn_eq_t ref;
+    dyn_eq_init(&ref, fs);
+    printf("fs %.0f Hz, tone %.1f dBFS rms, band %.0f Hz Q %.2f, threshold %.1f dB, ratio %.1f, range %.1f dB\n",
+           fs, level, ref.band[0].fc, ref.band[0].Q, ref.band[0].threshold_db,
+           ref.band[0].ratio, ref.band[0].range_db);
+    printf("%8s %9s\n", "Hz", "gain dB");
+    for (size_t i = 0; i < sizeof(freqs) / sizeof(freqs[0]); i++) {
+        if (freqs[i] >= 0.45f * fs) break;
+        printf("%8.0f %9.2f\n", freqs[i], tone_gain_db(fs, level, freqs[i]));
+    }
+    return 0;
+}
@@ -0,0 +1,9 @@
+#pragma once
+// Minimal esp_err.h for host tools that build against components/sim
+#include <stdint.h>
+
+typedef int32_t esp_err_t;
+
+#define ESP_OK               0
+#define ESP_FAIL            -1
+#define ESP_ERR_INVALID_ARG  0x102
@@ -0,0 +1,44 @@
+// Host cross-check and benchmark of the block kernels (main/dsp/dsp_kernels*.c):
+// the compiled backend against the scalar reference, same code as the
+// KERNELS console command.
+//
+// Build:  gcc -O2 -Imain/dsp tools/kernel_bench.c main/dsp/dsp_kernels_ref.c
+//             main/dsp/dsp_kernels_x86.c main/dsp/dsp_kernels_check.c -lm -o kernel_bench
+//         add -mavx2 for the AVX2 paths, -DDSP_KERNELS_SCALAR for the scalar backend
+// Usage:  ./kernel_bench [-n samples] [-i iterations]
+//
+// Exits non-zero if any kernel is outside its tolerance.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dsp_kernels.h"
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void report(const dsp_kernel_result_t *r)
+{
+    printf("%-16s %10.2g %5s %10.1f %10.1f %7.2fx\n", r->name, r->max_err, r->ok ? "ok" : "FAIL",
+           r->ref_ns, r->backend_ns, r->ref_ns / r->backend_ns);
+}
+
+int main(int argc, char **argv)
+{
+    int n = 128, iters = 100000;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) n = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-i") && i + 1 < argc) iters = atoi(argv[++i]);
+        else { fprintf(stderr, "usage: %s [-n samples] [-i iterations]\n", argv[0]); return 1; }
+    }
+
+    printf("backend %s, %d samples, %d iterations\n", dsp_kernels_backend(), n, iters);
+    printf("%-16s %10s %5s %10s %10s %8s\n", "kernel", "max err", "", "scalar ns", "backend ns", "speedup");
+    int failed = dsp_kernels_check(n, iters, now_ns, report);
+    return failed ? 1 : 0;
+}
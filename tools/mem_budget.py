@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""Per-module code/data size and IRAM headroom from the linker map.
+
+Run after `idf.py build`; compare a build with CONFIG_AUDIO_HOT_IRAM on and
+off to see what the hot path placement costs.
+
+    python tools/mem_budget.py build/<project>.map
+    python tools/mem_budget.py build/<project>.map --archive main -v
+
+Every input section of the selected component archive is attributed to its
+object file and classified by the memory segment it landed in:
+IRAM (code in internal RAM), FLASH (code run from the flash cache),
+DRAM (data + bss in internal RAM) and RODATA (constants in flash).
+"""
+import argparse
+import re
+import sys
+from collections import defaultdict
+
+CLASSES = ("IRAM", "FLASH", "DRAM", "RODATA")
+
+SEG_RE = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+OUT_RE = re.compile(r"^(\.\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s*$")
+IN_RE = re.compile(r"^ (\.\S+|COMMON)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S+)\s*$")
+NAME_ONLY_RE = re.compile(r"^ ?(\.\S+|COMMON)\s*$")
+CONT_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(\S+))?\s*$")
+
+
+def classify(seg):
+    """Segment name -> size class (IDF memory.ld names across targets)."""
+    n = seg.lower()
+    if n.startswith("rtc"):
+        return None
+    if "irom" in n or "iram0_2" in n:
+        return "FLASH"
+    if "drom" in n:
+        return "RODATA"
+    if "iram" in n:
+        return "IRAM"
+    if "dram" in n:
+        return "DRAM"
+    return None
+
+
+def parse_map(path):
+    segments = []          # (name, origin, length)
+    outputs = []           # (name, addr, size)
+    inputs = []            # (section, addr, size, file)
+
+    with open(path, errors="replace") as f:
+        lines = f.read().splitlines()
+
+    i = 0
+    while i < len(lines) and not lines[i].startswith("Memory Configuration"):
+        i += 1
+    i += 1
+    while i < len(lines) and not lines[i].startswith("Linker script and memory map"):
+        m = SEG_RE.match(lines[i])
+        if m and m.group(1) not in ("Name", "*default*"):
+            segments.append((m.group(1), int(m.group(2), 16), int(m.group(3), 16)))
+        i += 1
+
+    pending_out = pending_in = None
+    for line in lines[i:]:
+        if pending_out or pending_in:
+            m = CONT_RE.match(line)
+            if m:
+                addr, size, obj = int(m.group(1), 16), int(m.group(2), 16), m.group(3)
+                if pending_out and not obj:
+                    outputs.append((pending_out, addr, size))
+                elif pending_in and obj:
+                    inputs.append((pending_in, addr, size, obj))
+            pending_out = pending_in = None
+            continue
+
+        m = OUT_RE.match(line)
+        if m:
+            outputs.append((m.group(1), int(m.group(2), 16), int(m.group(3), 16)))
+            continue
+        m = IN_RE.match(line)
+        if m:
+            inputs.append((m.group(1), int(m.group(2), 16), int(m.group(3), 16), m.group(4)))
+            continue
+        m = NAME_ONLY_RE.match(line)
+        if m:
+            if line.startswith(" "):
+                pending_in = m.group(1)
+            else:
+                pending_out = m.group(1)
+
+    return segments, outputs, inputs
+
+
+def segment_of(segments, addr):
+    for name, origin, length in segments:
+        if origin <= addr < origin + length:
+            return name
+    return None
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("map", help="linker map (build/<project>.map)")
+    ap.add_argument("--archive", default="main", help="component archive to break down (lib<name>.a)")
+    ap.add_argument("-v", "--verbose", action="store_true", help="list every input section")
+    args = ap.parse_args()
+
+    segments, outputs, inputs = parse_map(args.map)
+    if not segments:
+        sys.exit(f"{args.map}: no memory configuration found, is this a GNU ld map?")
+
+    obj_re = re.compile(r"lib" + re.escape(args.archive) + r"\.a\(([^)]+?)(?:\.c)?\.obj\)")
+    sizes = defaultdict(lambda: dict.fromkeys(CLASSES, 0))
+    detail = defaultdict(list)
+
+    for section, addr, size, obj in inputs:
+        m = obj_re.search(obj)
+        if not m or size == 0 or addr == 0:
+            continue
+        cls = classify(segment_of(segments, addr) or "")
+        if cls is None:
+            continue
+        module = m.group(1)
+        sizes[module][cls] += size
+        detail[module].append((cls, section, size))
+
+    print(f"{'module':<16}" + "".join(f"{c:>9}" for c in CLASSES))
+    total = dict.fromkeys(CLASSES, 0)
+    for module in sorted(sizes):
+        row = sizes[module]
+        print(f"{module:<16}" + "".join(f"{row[c]:>9}" for c in CLASSES))
+        for c in CLASSES:
+            total[c] += row[c]
+        if args.verbose:
+            for cls, section, size in sorted(detail[module]):
+                print(f"    {cls:<7} {size:>7}  {section}")
+    print(f"{'total':<16}" + "".join(f"{total[c]:>9}" for c in CLASSES))
+
+    # headroom: highest end address of any output section in each IRAM segment
+    print()
+    for name, origin, length in segments:
+        if classify(name) != "IRAM":
+            continue
+        ends = [a + s for _, a, s in outputs if origin <= a < origin + length]
+        used = (max(ends) - origin) if ends else 0
+        print(f"{name}: {used} / {length} bytes used, {length - used} free "
+              f"({100.0 * used / length:.1f}%)")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,181 @@
+// Host benchmark of the precompiled pipeline variants (main/dsp/pipeline_static.c)
+// against the generic stage-by-stage loop, for every stage combination.
+//
+// Build:  gcc -O2 -Imain/dsp -Imain/audio_io tools/pipeline_bench.c main/dsp/pipeline.c main/dsp/pipeline_static.c
+//             main/dsp/iir_filter.c main/dsp/biquad.c main/dsp/dyn_eq.c main/dsp/rms.c
+//             main/dsp/expander.c main/dsp/compressor.c main/dsp/limiter.c
+//             main/dsp/dsp_kernels_ref.c main/dsp/dsp_kernels_x86.c -lm -o pipeline_bench
+// Usage:  ./pipeline_bench [-n blocks] [-r runs] [-d] [-c]
+//
+// -d bypasses the dynamic EQ, -c the soft clip (both run as block passes in
+// every variant). Both paths start from the same DSP state and get the same
+// input, so max|diff| should be 0. The two paths alternate for -r runs and
+// the fastest run of each is reported, single runs vary by +-20 % on a busy
+// host.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "pipeline.h"
+#include "pipeline_static.h"
+#include "iir_filter.h"
+#include "rms.h"
+#include "expander.h"
+#include "compressor.h"
+#include "limiter.h"
+#include "dyn_eq.h"
+
+#define FS      48000.0f
+#define BLOCK   PIPELINE_STATIC_BLOCK
+
+static const stage_id_t fused[] = { STAGE_EQ, STAGE_EXPANDER, STAGE_COMPRESSOR, STAGE_LIMITER };
+#define FUSED_COUNT  (sizeof(fused) / sizeof(fused[0]))
+
+static rms_filter_t rms;
+static expander_t expd;
+static compressor_t comp;
+static limiter_t lim;
+static dyn_eq_t dyn;
+
+typedef struct {
+    eq3band_t eq;
+    rms_filter_t rms;
+    expander_t expd;
+    compressor_t comp;
+    limiter_t lim;
+    dyn_eq_t dyn;
+} dsp_state_t;
+
+static void save(dsp_state_t *s)
+{
+    s->eq = *eq_state();
+    s->rms = rms; s->expd = expd; s->comp = comp; s->lim = lim; s->dyn = dyn;
+}
+
+static void restore(const dsp_state_t *s)
+{
+    *eq_state() = s->eq;
+    rms = s->rms; expd = s->expd; comp = s->comp; lim = s->lim; dyn = s->dyn;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// speech-like bursts over a noise floor, so every dynamics stage moves
+static void make_input(float *x, long len)
+{
+    uint32_t seed = 12345;
+    for (long i = 0; i < len; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float noise = ((float)(seed >> 9) / 8388608.0f - 1.0f) * 0.003f;
+        float t = (float)i / FS;
+        float env = 0.5f + 0.5f * sinf(2.0f * (float)M_PI * 2.5f * t);
+        x[i] = 0.8f * env * env * sinf(2.0f * (float)M_PI * 440.0f * t)
+             + 0.1f * sinf(2.0f * (float)M_PI * 6500.0f * t) + noise;
+    }
+}
+
+// Runs `blocks` blocks through the pipeline as it is configured, returns ns/block
+static double run(pipeline_t *p, const float *in, float *out, int blocks)
+{
+    double t0 = now_ns();
+    for (int b = 0; b < blocks; b++) {
+        memcpy(&out[b * BLOCK], &in[b * BLOCK], BLOCK * sizeof(float));
+        pipeline_process(p, &out[b * BLOCK], BLOCK, true);
+    }
+    return (now_ns() - t0) / blocks;
+}
+
+int main(int argc, char **argv)
+{
+    int blocks = 4000, runs = 9;
+    bool dyn_on = true, clip_on = true;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) blocks = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc) runs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-d")) dyn_on = false;
+        else if (!strcmp(argv[i], "-c")) clip_on = false;
+        else { fprintf(stderr, "usage: %s [-n blocks] [-r runs] [-d] [-c]\n", argv[0]); return 1; }
+    }
+
+    // same setup as app_main()
+    eq_init(FS);
+    rms_init(&rms, FS, 20.0f);
+    limiter_init(&lim, FS, 0.6f, 3.0f, 150.0f);
+    compressor_init(&comp, FS, 0.3f, 4.0f, 4.0f, 10.0f, 120.0f, 6.0f);
+    expander_init(&expd, FS, 0.02f, 2.0f, 5.0f, 100.0f, 100.0f);
+    dyn_eq_init(&dyn, FS);
+    dyn.band[0].enabled = true;
+    dyn_eq_update(&dyn);
+
+    static pipeline_t p;
+    pipeline_init(&p, FS, 10.0f);
+    pipeline_bind(&p, STAGE_DYNEQ, &dyn);
+    pipeline_bind(&p, STAGE_RMS, &rms);
+    pipeline_bind(&p, STAGE_EXPANDER, &expd);
+    pipeline_bind(&p, STAGE_COMPRESSOR, &comp);
+    pipeline_bind(&p, STAGE_LIMITER, &lim);
+
+    long len = (long)blocks * BLOCK;
+    float *in = malloc(len * sizeof(float));
+    float *out_g = malloc(len * sizeof(float));
+    float *out_s = malloc(len * sizeof(float));
+    if (!in || !out_g || !out_s) return 1;
+    make_input(in, len);
+
+    if (runs < 1) runs = 1;
+    printf("block %d, %d blocks, best of %d, dynamic EQ %s, soft clip %s\n",
+           BLOCK, blocks, runs, dyn_on ? "on" : "bypassed", clip_on ? "on" : "bypassed");
+    printf("%-28s %12s %12s %8s %10s\n", "stages", "generic ns", "static ns", "speedup", "max|diff|");
+
+    for (unsigned m = 0; m < (1u << FUSED_COUNT); m++) {
+        char name[64] = "";
+        for (unsigned k = 0; k < FUSED_COUNT; k++) {
+            pipeline_set_bypass(&p, fused[k], !(m & (1u << k)));
+            if (m & (1u << k))
+                snprintf(name + strlen(name), sizeof(name) - strlen(name), "%s%s",
+                         *name ? "+" : "", stage_name(fused[k]));
+        }
+        if (!*name) strcpy(name, "(RMS only)");
+        pipeline_set_bypass(&p, STAGE_DYNEQ, !dyn_on);
+        pipeline_set_bypass(&p, STAGE_SOFTCLIP, !clip_on);
+
+        // settle the crossfades on the generic path
+        pipeline_use_variants(&p, false);
+        pipeline_commit(&p);
+        run(&p, in, out_g, 64);
+
+        dsp_state_t s;
+        save(&s);
+        double t_gen = INFINITY, t_var = INFINITY;
+        for (int r = 0; r < runs; r++) {
+            restore(&s);
+            pipeline_use_variants(&p, false);
+            pipeline_commit(&p);
+            t_gen = fmin(t_gen, run(&p, in, out_g, blocks));
+
+            restore(&s);
+            pipeline_use_variants(&p, true);
+            pipeline_commit(&p);
+            t_var = fmin(t_var, run(&p, in, out_s, blocks));
+        }
+        if (!p.active->variant) {
+            printf("%-28s %12.0f %12s\n", name, t_gen, "n/a");
+            continue;
+        }
+
+        float diff = 0.0f;
+        for (long i = 0; i < len; i++)
+            diff = fmaxf(diff, fabsf(out_g[i] - out_s[i]));
+        printf("%-28s %12.0f %12.0f %7.2fx %10.2g\n", name, t_gen, t_var, t_gen / t_var, diff);
+    }
+
+    free(in); free(out_g); free(out_s);
+    return 0;
+}
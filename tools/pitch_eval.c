@@ -0,0 +1,324 @@
+// Host accuracy check of the F0 tracker (main/dsp/pitch.c): synthetic voices
+// at every supported rate, and recorded clips against a reference track.
+//
+// Build:  gcc -O2 -Imain/dsp -Icomponents/sim/include -Itools/host tools/pitch_eval.c
+//             main/dsp/pitch.c main/dsp/halfband.c main/dsp/dsp_kernels_ref.c
+//             main/dsp/dsp_kernels_x86.c components/sim/sim_dsp.c -lm -o pitch_eval
+// Usage:  ./pitch_eval [-h hop_ms]                       synthetic suite
+//         ./pitch_eval [-h hop_ms] [-t] clip.wav [ref.txt] [...]
+//
+// Reference tracks have one frame per line, "<time_s> <f0_hz>", 0 Hz for
+// unvoiced (Praat / REAPER style exports). -t prints the tracker output.
+//
+// Scores: gross pitch error (GPE, voiced frames more than 20 % off), mean
+// absolute error of the rest in cents, and for references the voicing
+// decision error. The synthetic suite also checks the FFT autocorrelation
+// against the O(N²) time-domain NSDF and exits non-zero on a failure.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "pitch.h"
+
+#define BLOCK       128
+#define MAX_REF     200000
+#define GROSS       0.2         // relative error counted as gross
+#define SETTLE_S    0.1         // synthetic: first analyses not scored
+
+typedef struct { double t, f0; } ref_t;
+
+typedef struct {
+    long frames, voiced_ref, voiced_hit, gross, vde;
+    double cents;
+} score_t;
+
+static float *read_wav(const char *path, int *fs, long *count)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) { perror(path); return NULL; }
+
+    uint8_t hdr[12];
+    if (fread(hdr, 1, 12, f) != 12 || memcmp(hdr, "RIFF", 4) || memcmp(hdr + 8, "WAVE", 4)) {
+        fprintf(stderr, "%s: not a RIFF/WAVE file\n", path);
+        fclose(f);
+        return NULL;
+    }
+
+    int channels = 0, bits = 0;
+    float *out = NULL;
+    uint8_t ck[8];
+    while (fread(ck, 1, 8, f) == 8) {
+        uint32_t size = ck[4] | (ck[5] << 8) | (ck[6] << 16) | ((uint32_t)ck[7] << 24);
+        if (!memcmp(ck, "fmt ", 4)) {
+            uint8_t fmt[16];
+            if (size < 16 || fread(fmt, 1, 16, f) != 16) break;
+            channels = fmt[2] | (fmt[3] << 8);
+            *fs      = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | (fmt[7] << 24);
+            bits     = fmt[14] | (fmt[15] << 8);
+            fseek(f, size - 16 + (size & 1), SEEK_CUR);
+        } else if (!memcmp(ck, "data", 4)) {
+            if (bits != 16 || channels < 1) {
+                fprintf(stderr, "%s: only 16-bit PCM is supported\n", path);
+                break;
+            }
+            long frames = size / (2 * channels);
+            int16_t *raw = malloc(size);
+            out = malloc(frames * sizeof(float));
+            if (!raw || !out || fread(raw, 1, size, f) != size) {
+                free(raw); free(out); out = NULL;
+                break;
+            }
+            for (long i = 0; i < frames; i++)
+                out[i] = raw[i * channels] / 32768.0f;   // first channel
+            free(raw);
+            *count = frames;
+            break;
+        } else {
+            fseek(f, size + (size & 1), SEEK_CUR);
+        }
+    }
+    fclose(f);
+    if (!out) fprintf(stderr, "%s: no usable data chunk\n", path);
+    return out;
+}
+
+static int read_ref(const char *path, ref_t *r, int max)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) { perror(path); return -1; }
+    char line[256];
+    int n = 0;
+    while (n < max && fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "%lf %lf", &r[n].t, &r[n].f0) == 2) n++;
+    }
+    fclose(f);
+    return n;
+}
+
+// nearest reference frame, the file is in time order
+static double ref_at(const ref_t *r, int n, double t)
+{
+    int lo = 0, hi = n - 1;
+    if (n <= 0) return 0.0;
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (r[mid].t <= t) lo = mid; else hi = mid;
+    }
+    return (fabs(r[hi].t - t) < fabs(r[lo].t - t)) ? r[hi].f0 : r[lo].f0;
+}
+
+static void score_frame(score_t *s, double ref, const pitch_t *p)
+{
+    s->frames++;
+    if ((ref > 0) != p->voiced) s->vde++;
+    if (ref <= 0) return;
+    s->voiced_ref++;
+    if (!p->voiced) return;
+    s->voiced_hit++;
+    if (fabs(p->f0 - ref) > GROSS * ref) s->gross++;
+    else s->cents += fabs(1200.0 * log2(p->f0 / ref));
+}
+
+static double gpe(const score_t *s)
+{
+    return s->voiced_hit ? 100.0 * s->gross / s->voiced_hit : 0.0;
+}
+
+static double mean_cents(const score_t *s)
+{
+    long fine = s->voiced_hit - s->gross;
+    return fine ? s->cents / fine : 0.0;
+}
+
+// Middle of the analysis window in input time: window end, less half a
+// window at the decimated rate
+static double frame_time(const pitch_t *p, long end)
+{
+    return end / (double)p->fs - 0.5 * PITCH_WINDOW / p->rate;
+}
+
+// O(N²) NSDF of the window the tracker just analysed
+static double nsdf_check(const pitch_t *p)
+{
+    double x[PITCH_WINDOW], mean = 0.0, worst = 0.0;
+    for (int i = 0; i < PITCH_WINDOW; i++) mean += p->hist[i];
+    mean /= PITCH_WINDOW;
+    for (int i = 0; i < PITCH_WINDOW; i++) x[i] = p->hist[i] - mean;
+
+    for (int t = 0; t <= p->lag_max + 1; t++) {
+        double r = 0.0, m = 0.0;
+        for (int j = 0; j + t < PITCH_WINDOW; j++) {
+            r += x[j] * x[j + t];
+            m += x[j] * x[j] + x[j + t] * x[j + t];
+        }
+        double d = fabs((m > 0 ? 2.0 * r / m : 0.0) - p->nsdf[t]);
+        if (d > worst) worst = d;
+    }
+    return worst;
+}
+
+typedef enum { SIG_SINE, SIG_BUZZ, SIG_VOWEL, SIG_VIBRATO, SIG_COUNT } signal_t;
+static const char *const sig_names[SIG_COUNT] = { "sine", "buzz", "vowel", "vibrato" };
+
+static uint32_t rng = 12345;
+static double noise(void)
+{
+    rng = rng * 1664525u + 1013904223u;
+    return (rng >> 8) * (1.0 / 16777216.0) * 2.0 - 1.0;
+}
+
+// Instantaneous F0 of the synthetic signal at time t
+static double synth_f0(signal_t sig, double f0, double t)
+{
+    return (sig == SIG_VIBRATO) ? f0 * (1.0 + 0.03 * sin(2.0 * M_PI * 5.0 * t)) : f0;
+}
+
+// One sample; phase in cycles. "vowel" is a harmonic series through two
+// formant-like resonances with a weak fundamental.
+static double synth_sample(signal_t sig, double f0, double phase, int fs)
+{
+    if (sig == SIG_SINE) return sin(2.0 * M_PI * phase);
+
+    double y = 0.0;
+    for (int k = 1; k * f0 < 0.45 * fs && k * f0 < 4000.0; k++) {
+        double a = 1.0 / k;
+        if (sig == SIG_VOWEL) {
+            double fk = k * f0;
+            a = 0.3 / k + 1.0 / (1.0 + pow((fk - 700.0) / 150.0, 2))
+                        + 0.5 / (1.0 + pow((fk - 1200.0) / 200.0, 2));
+            if (k == 1) a *= 0.3;
+        }
+        y += a * sin(2.0 * M_PI * k * phase);
+    }
+    return y;
+}
+
+static int run_synthetic(float hop_ms)
+{
+    static const int rates[] = { 16000, 32000, 44100, 48000 };
+    static const double f0s[] = { 70, 100, 150, 220, 330, 500, 800 };
+    const double snr_db = 20.0, level = 0.25, seconds = 1.0;
+    int fail = 0;
+    double worst_nsdf = 0.0;
+
+    printf("%-8s %6s  %8s %8s %8s\n", "signal", "fs", "voiced%", "GPE%", "cents");
+    for (int s = 0; s < SIG_COUNT; s++) {
+        for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+            int fs = rates[r];
+            score_t sc = {0};
+            static pitch_t p;
+
+            for (size_t k = 0; k < sizeof(f0s) / sizeof(f0s[0]); k++) {
+                pitch_init(&p, (float)fs, hop_ms);
+                long count = (long)(seconds * fs);
+                double phase = 0.0, peak = 0.0;
+                float *x = malloc(count * sizeof(float));
+                for (long i = 0; i < count; i++) {
+                    phase += synth_f0((signal_t)s, f0s[k], i / (double)fs) / fs;
+                    x[i] = (float)synth_sample((signal_t)s, f0s[k], phase, fs);
+                    peak = fmax(peak, fabs(x[i]));
+                }
+                double n_amp = level / sqrt(2.0) * pow(10.0, -snr_db / 20.0) * sqrt(3.0);
+                for (long i = 0; i < count; i++)
+                    x[i] = (float)(x[i] * level / peak + n_amp * noise());
+
+                for (long i = 0; i + BLOCK <= count; i += BLOCK) {
+                    if (!pitch_process(&p, &x[i], BLOCK)) continue;
+                    worst_nsdf = fmax(worst_nsdf, nsdf_check(&p));
+                    double t = frame_time(&p, i + BLOCK);
+                    if (t < SETTLE_S) continue;
+                    score_frame(&sc, synth_f0((signal_t)s, f0s[k], t), &p);
+                }
+                free(x);
+            }
+
+            double voiced = sc.voiced_ref ? 100.0 * sc.voiced_hit / sc.voiced_ref : 0.0;
+            printf("%-8s %6d  %8.1f %8.2f %8.2f\n", sig_names[s], fs, voiced, gpe(&sc), mean_cents(&sc));
+            if (voiced < 95.0 || gpe(&sc) > 2.0 || mean_cents(&sc) > 15.0) fail = 1;
+        }
+    }
+
+    // unvoiced input: white noise and silence must not report a pitch
+    static pitch_t p;
+    pitch_init(&p, 48000.0f, hop_ms);
+    long frames = 0, voiced = 0;
+    float blk[BLOCK];
+    for (long i = 0; i < 48000; i += BLOCK) {
+        for (int j = 0; j < BLOCK; j++) blk[j] = (i < 24000) ? (float)(0.1 * noise()) : 0.0f;
+        if (pitch_process(&p, blk, BLOCK)) { frames++; voiced += p.voiced; }
+    }
+    printf("noise/silence: %ld of %ld frames voiced\n", voiced, frames);
+    if (voiced > frames / 20) fail = 1;
+
+    printf("FFT vs time-domain NSDF: max |diff| %.2e\n", worst_nsdf);
+    if (worst_nsdf > 1e-3) fail = 1;
+
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
+
+static void print_score(const char *name, const score_t *s)
+{
+    printf("%-32s frames=%6ld  voiced=%6ld", name, s->frames, s->voiced_hit);
+    if (s->voiced_ref || s->vde)
+        printf("  GPE=%5.2f%%  cents=%6.2f  VDE=%5.2f%%", gpe(s), mean_cents(s),
+               s->frames ? 100.0 * s->vde / s->frames : 0.0);
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    float hop_ms = PITCH_HOP_MS;
+    int track = 0, argi = 1;
+    for (; argi < argc && argv[argi][0] == '-'; argi++) {
+        if (!strcmp(argv[argi], "-h") && argi + 1 < argc) hop_ms = strtof(argv[++argi], NULL);
+        else if (!strcmp(argv[argi], "-t")) track = 1;
+        else {
+            fprintf(stderr, "usage: %s [-h hop_ms] [-t] [clip.wav [ref.txt] ...]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (argi == argc) return run_synthetic(hop_ms);
+
+    static ref_t ref[MAX_REF];
+    static pitch_t p;
+    score_t total = {0};
+
+    while (argi < argc) {
+        const char *wav = argv[argi++];
+        int n_ref = -1;
+        if (argi < argc && !strstr(argv[argi], ".wav")) {
+            n_ref = read_ref(argv[argi++], ref, MAX_REF);
+            if (n_ref < 0) return 1;
+        }
+
+        int fs = 0;
+        long count = 0;
+        float *x = read_wav(wav, &fs, &count);
+        if (!x) return 1;
+
+        pitch_init(&p, (float)fs, hop_ms);
+        score_t s = {0};
+        for (long i = 0; i + BLOCK <= count; i += BLOCK) {
+            if (!pitch_process(&p, &x[i], BLOCK)) continue;
+            double t = frame_time(&p, i + BLOCK);
+            if (track) printf("%.3f %.1f %.2f\n", t, p.f0, p.clarity);
+            if (n_ref >= 0) {
+                score_frame(&s, ref_at(ref, n_ref, t), &p);
+            } else {
+                s.frames++;
+                s.voiced_hit += p.voiced;
+            }
+        }
+
+        print_score(wav, &s);
+        total.frames += s.frames; total.voiced_ref += s.voiced_ref; total.voiced_hit += s.voiced_hit;
+        total.gross += s.gross; total.vde += s.vde; total.cents += s.cents;
+        free(x);
+    }
+
+    print_score("TOTAL", &total);
+    return 0;
+}
@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""Convert a trace dump (TRACE DUMP) into Chrome trace JSON.
+
+Reads the framed binary dump either live from the serial port or from a
+file saved earlier and writes a JSON file that chrome://tracing and
+https://ui.perfetto.dev open directly:
+
+  - one track per core with the task running on it (task switch hooks)
+  - one track per task with its markers (I2S, pipeline stages, FFT, ...)
+
+    python trace_to_chrome.py --port /dev/ttyUSB0 --dump-baud 921600 -o glitch.json
+    python trace_to_chrome.py --file dump.bin -o glitch.json
+
+Same framing as the capture dump, see capture_to_wav.py.
+"""
+import argparse
+import json
+import os
+import struct
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from capture_to_wav import FrameParser  # noqa: E402
+
+FRAME_TRACE_HEADER = 0x10
+FRAME_TRACE_NAME = 0x11
+FRAME_TRACE_EVENTS = 0x12
+FRAME_TRACE_END = 0x13
+
+EV_SWITCH_IN, EV_SWITCH_OUT, EV_BEGIN, EV_END = 1, 2, 3, 4
+
+PID = 1
+TASK_TID_BASE = 100         # marker tracks, after the core tracks
+
+
+def read_dump(source, parser):
+    dump = None
+    for chunk in source:
+        for ftype, payload in parser.feed(chunk):
+            if ftype == FRAME_TRACE_HEADER:
+                ver, cores, per_core = struct.unpack_from("<BBI", payload)
+                dump = dict(version=ver, cores=cores, per_core=per_core, tasks={}, spans={},
+                            events=[[] for _ in range(cores)], recorded=None)
+                print(f"header: {cores} cores, {per_core} events per core", file=sys.stderr)
+            elif not dump:
+                continue
+            elif ftype == FRAME_TRACE_NAME:
+                kind, ident = payload[0], payload[1]
+                name = payload[2:].decode(errors="replace")
+                (dump["tasks"] if kind == 0 else dump["spans"])[ident] = name
+            elif ftype == FRAME_TRACE_EVENTS:
+                core, count = payload[0], payload[1]
+                for i in range(count):
+                    dump["events"][core].append(struct.unpack_from("<IBBH", payload, 2 + 8 * i))
+            elif ftype == FRAME_TRACE_END:
+                dump["recorded"] = list(struct.unpack_from(f"<{dump['cores']}I", payload))
+                return dump
+    return dump
+
+
+def serial_source(port, baud, dump_baud, timeout):
+    import serial
+    ser = serial.Serial(port, baud, timeout=0.2)
+    ser.reset_input_buffer()
+    cmd = f"TRACE DUMP {dump_baud}\n" if dump_baud else "TRACE DUMP\n"
+    ser.write(cmd.encode())
+
+    if dump_baud:
+        line = b""
+        deadline = time.time() + 5
+        while b"TRACE:BAUD=" not in line and time.time() < deadline:
+            line = ser.readline()
+        ser.baudrate = dump_baud
+
+    last = time.time()
+    try:
+        while time.time() - last < timeout:
+            data = ser.read(4096)
+            if data:
+                last = time.time()
+                yield data
+    finally:
+        if dump_baud:
+            ser.baudrate = baud
+        ser.close()
+
+
+def file_source(path):
+    with open(path, "rb") as f:
+        while True:
+            data = f.read(65536)
+            if not data:
+                return
+            yield data
+
+
+def unwrap(events):
+    """32-bit µs timestamps → monotonic, then time order (task switch
+    interrupts can land between a marker's slot and its timestamp)."""
+    out, base, prev = [], 0, None
+    for ts, typ, ident, arg in events:
+        if prev is not None and ts < prev and prev - ts > 1 << 31:
+            base += 1 << 32
+        prev = ts
+        out.append((base + ts, typ, ident, arg))
+    out.sort(key=lambda e: e[0])
+    return out
+
+
+def convert(dump):
+    tasks, spans = dump["tasks"], dump["spans"]
+    task_name = lambda t: tasks.get(t, f"task {t}" if t else "unknown task")
+    trace = []
+    stats = {}
+
+    per_core = [unwrap(ev) for ev in dump["events"]]
+    t0 = min((ev[0][0] for ev in per_core if ev), default=0)
+    t_end = max((ev[-1][0] for ev in per_core if ev), default=0)
+
+    for core in range(dump["cores"]):
+        trace.append(dict(ph="M", pid=PID, tid=core, name="thread_name", args=dict(name=f"core {core}")))
+        trace.append(dict(ph="M", pid=PID, tid=core, name="thread_sort_index", args=dict(sort_index=core)))
+    trace.append(dict(ph="M", pid=PID, name="process_name", args=dict(name="ESP32")))
+
+    marker_tasks = set()
+    stacks = {}                 # task → open markers [(span, ts)]
+    for core, events in enumerate(per_core):
+        running = None          # (task, since)
+        for ts, typ, ident, arg in events:
+            t = ts - t0
+            if typ == EV_SWITCH_IN:
+                running = (ident, t)
+            elif typ == EV_SWITCH_OUT:
+                if running and running[0] == ident:
+                    trace.append(dict(ph="X", pid=PID, tid=core, ts=running[1], dur=t - running[1],
+                                      name=task_name(ident)))
+                running = None
+            elif typ in (EV_BEGIN, EV_END):
+                tid = TASK_TID_BASE + arg
+                marker_tasks.add(arg)
+                stack = stacks.setdefault(arg, [])
+                name = spans.get(ident, f"span {ident}")
+                if typ == EV_BEGIN:
+                    stack.append((ident, t))
+                    trace.append(dict(ph="B", pid=PID, tid=tid, ts=t, name=name, args=dict(core=core)))
+                elif any(s == ident for s, _ in stack):
+                    # close anything left open inside it (lost END)
+                    while stack:
+                        s, since = stack.pop()
+                        trace.append(dict(ph="E", pid=PID, tid=tid, ts=t, name=spans.get(s, f"span {s}")))
+                        if s == ident:
+                            st = stats.setdefault(name, [])
+                            st.append(t - since)
+                            break
+                # END without BEGIN: the BEGIN was overwritten, drop it
+        if running:
+            trace.append(dict(ph="X", pid=PID, tid=core, ts=running[1], dur=t_end - t0 - running[1],
+                              name=task_name(running[0])))
+
+    for task, stack in stacks.items():
+        for s, _ in reversed(stack):
+            trace.append(dict(ph="E", pid=PID, tid=TASK_TID_BASE + task, ts=t_end - t0,
+                              name=spans.get(s, f"span {s}")))
+    for task in marker_tasks:
+        trace.append(dict(ph="M", pid=PID, tid=TASK_TID_BASE + task, name="thread_name",
+                          args=dict(name=task_name(task))))
+        trace.append(dict(ph="M", pid=PID, tid=TASK_TID_BASE + task, name="thread_sort_index",
+                          args=dict(sort_index=TASK_TID_BASE + task)))
+
+    return trace, stats, (t_end - t0)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    src = ap.add_mutually_exclusive_group(required=True)
+    src.add_argument("--port", help="serial port, sends TRACE DUMP itself")
+    src.add_argument("--file", help="raw dump saved from the serial port")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--dump-baud", type=int, default=0, help="ask the device to dump at this rate")
+    ap.add_argument("--timeout", type=float, default=3.0, help="seconds of silence that end the dump")
+    ap.add_argument("-o", "--output", default="trace.json")
+    args = ap.parse_args()
+
+    parser = FrameParser()
+    source = serial_source(args.port, args.baud, args.dump_baud, args.timeout) if args.port else file_source(args.file)
+    dump = read_dump(source, parser)
+    if not dump:
+        sys.exit("no trace header found")
+    if dump["recorded"] is None:
+        print("warning: dump ended early", file=sys.stderr)
+
+    trace, stats, span_us = convert(dump)
+    with open(args.output, "w") as f:
+        json.dump(dict(traceEvents=trace, displayTimeUnit="ms"), f)
+
+    counts = [len(e) for e in dump["events"]]
+    print(f"{sum(counts)} events ({', '.join(f'core {c}: {n}' for c, n in enumerate(counts))}) "
+          f"over {span_us / 1000:.1f} ms -> {args.output}")
+    for core, rec in enumerate(dump["recorded"] or []):
+        if rec > dump["per_core"]:
+            print(f"  core {core}: oldest {rec - dump['per_core']} events overwritten")
+    print(f"{'marker':<20} {'count':>7} {'mean us':>9} {'max us':>8}")
+    for name, d in sorted(stats.items(), key=lambda kv: -max(kv[1])):
+        print(f"{name:<20} {len(d):>7} {sum(d) / len(d):>9.1f} {max(d):>8}")
+    print(f"bad frames: {parser.bad_crc}")
+
+
+if __name__ == "__main__":
+    main()
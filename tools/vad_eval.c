@@ -0,0 +1,227 @@
+// Host evaluation of the VAD (main/dsp/vad.c) against labelled WAV clips.
+//
+// Build:  gcc -O2 -Imain/dsp tools/vad_eval.c main/dsp/vad.c -lm -o vad_eval
+// Usage:  ./vad_eval [-g pre_gain] clip.wav clip.txt [clip2.wav clip2.txt ...]
+//
+// Labels use the Audacity label format, one speech region per line:
+//     <start_s> <end_s> [label]
+// The clip is processed in 128-sample blocks with the same 512-point Hann /
+// 8-band spectrum as fft.c, and every block decision is scored against the
+// labels.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "vad.h"
+
+#define BLOCK     128
+#define FFT_SIZE  512
+#define MAX_LABELS 1024
+
+typedef struct { double start, end; } region_t;
+
+typedef struct {
+    long tp, fp, tn, fn;
+} score_t;
+
+static float *read_wav(const char *path, int *fs, long *count)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) { perror(path); return NULL; }
+
+    uint8_t hdr[12];
+    if (fread(hdr, 1, 12, f) != 12 || memcmp(hdr, "RIFF", 4) || memcmp(hdr + 8, "WAVE", 4)) {
+        fprintf(stderr, "%s: not a RIFF/WAVE file\n", path);
+        fclose(f);
+        return NULL;
+    }
+
+    int channels = 0, bits = 0;
+    float *out = NULL;
+    uint8_t ck[8];
+    while (fread(ck, 1, 8, f) == 8) {
+        uint32_t size = ck[4] | (ck[5] << 8) | (ck[6] << 16) | ((uint32_t)ck[7] << 24);
+        if (!memcmp(ck, "fmt ", 4)) {
+            uint8_t fmt[16];
+            if (size < 16 || fread(fmt, 1, 16, f) != 16) break;
+            channels = fmt[2] | (fmt[3] << 8);
+            *fs      = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | (fmt[7] << 24);
+            bits     = fmt[14] | (fmt[15] << 8);
+            fseek(f, size - 16 + (size & 1), SEEK_CUR);
+        } else if (!memcmp(ck, "data", 4)) {
+            if (bits != 16 || channels < 1) {
+                fprintf(stderr, "%s: only 16-bit PCM is supported\n", path);
+                break;
+            }
+            long frames = size / (2 * channels);
+            int16_t *raw = malloc(size);
+            out = malloc(frames * sizeof(float));
+            if (!raw || !out || fread(raw, 1, size, f) != size) {
+                free(raw); free(out); out = NULL;
+                break;
+            }
+            for (long i = 0; i < frames; i++)
+                out[i] = raw[i * channels] / 32768.0f;   // first channel
+            free(raw);
+            *count = frames;
+            break;
+        } else {
+            fseek(f, size + (size & 1), SEEK_CUR);
+        }
+    }
+    fclose(f);
+    if (!out) fprintf(stderr, "%s: no usable data chunk\n", path);
+    return out;
+}
+
+static int read_labels(const char *path, region_t *r, int max)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) { perror(path); return -1; }
+    char line[256];
+    int n = 0;
+    while (n < max && fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "%lf %lf", &r[n].start, &r[n].end) == 2) n++;
+    }
+    fclose(f);
+    return n;
+}
+
+static int is_speech(const region_t *r, int n, double t)
+{
+    for (int i = 0; i < n; i++)
+        if (t >= r[i].start && t < r[i].end) return 1;
+    return 0;
+}
+
+// in-place radix-2 complex FFT, data = re,im interleaved
+static void fft(float *d, int n)
+{
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            float t;
+            t = d[2*i];   d[2*i]   = d[2*j];   d[2*j]   = t;
+            t = d[2*i+1]; d[2*i+1] = d[2*j+1]; d[2*j+1] = t;
+        }
+    }
+    for (int len = 2; len <= n; len <<= 1) {
+        double ang = -2.0 * M_PI / len;
+        for (int i = 0; i < n; i += len) {
+            for (int k = 0; k < len / 2; k++) {
+                float wr = (float)cos(ang * k), wi = (float)sin(ang * k);
+                float *a = &d[2 * (i + k)], *b = &d[2 * (i + k + len / 2)];
+                float tr = b[0] * wr - b[1] * wi;
+                float ti = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - tr; b[1] = a[1] - ti;
+                a[0] += tr;       a[1] += ti;
+            }
+        }
+    }
+}
+
+// same band layout and scaling as analyze_fft_and_send()
+static void spectrum_bands(const float *x, int fs, float *bands)
+{
+    static float win[FFT_SIZE];
+    static float data[2 * FFT_SIZE];
+    static int init = 0;
+    if (!init) {
+        for (int i = 0; i < FFT_SIZE; i++)
+            win[i] = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / (FFT_SIZE - 1));
+        init = 1;
+    }
+
+    float win_sum = 0.0f;
+    for (int i = 0; i < FFT_SIZE; i++) {
+        data[2*i]   = x[i] * win[i];
+        data[2*i+1] = 0.0f;
+        win_sum += win[i];
+    }
+    fft(data, FFT_SIZE);
+    float win_gain = win_sum / FFT_SIZE;
+
+    const float edges[9] = {60, 120, 250, 500, 1000, 2000, 4000, 8000, 16000};
+    for (int b = 0; b < 8; b++) {
+        int start = (int)(edges[b]   * FFT_SIZE / fs);
+        int end   = (int)(edges[b+1] * FFT_SIZE / fs);
+        if (start < 1) start = 1;
+        if (end > FFT_SIZE/2) end = FFT_SIZE/2;
+        if (end <= start) end = start + 1;
+        float acc = 0.0f;
+        for (int i = start; i < end; i++) {
+            float re = data[2*i] / win_gain, im = data[2*i+1] / win_gain;
+            acc += re*re + im*im;
+        }
+        acc /= (float)(end - start);
+        bands[b] = 10.0f * log10f(acc + 1e-12f);
+    }
+}
+
+static void print_score(const char *name, const score_t *s)
+{
+    long total = s->tp + s->fp + s->tn + s->fn;
+    double acc    = total ? 100.0 * (s->tp + s->tn) / total : 0.0;
+    double recall = (s->tp + s->fn) ? 100.0 * s->tp / (s->tp + s->fn) : 0.0;
+    double fa     = (s->fp + s->tn) ? 100.0 * s->fp / (s->fp + s->tn) : 0.0;
+    printf("%-32s blocks=%7ld  acc=%5.1f%%  speech-hit=%5.1f%%  false-alarm=%5.1f%%\n",
+           name, total, acc, recall, fa);
+}
+
+int main(int argc, char **argv)
+{
+    float pre_gain = 1.0f;
+    int argi = 1;
+    if (argi + 1 < argc && !strcmp(argv[argi], "-g")) {
+        pre_gain = strtof(argv[argi + 1], NULL);
+        argi += 2;
+    }
+    if (argc - argi < 2 || (argc - argi) % 2) {
+        fprintf(stderr, "usage: %s [-g pre_gain] clip.wav labels.txt [...]\n", argv[0]);
+        return 2;
+    }
+
+    static region_t regions[MAX_LABELS];
+    score_t total = {0};
+
+    for (; argi + 1 < argc; argi += 2) {
+        int fs = 0;
+        long count = 0;
+        float *x = read_wav(argv[argi], &fs, &count);
+        int n_reg = read_labels(argv[argi + 1], regions, MAX_LABELS);
+        if (!x || n_reg < 0) { free(x); return 1; }
+
+        vad_t vad;
+        vad_init(&vad, (float)fs, BLOCK, 300.0f);
+        score_t s = {0};
+        float bands[8];
+
+        for (long i = 0; i + BLOCK <= count; i += BLOCK) {
+            float blk[BLOCK];
+            for (int k = 0; k < BLOCK; k++) blk[k] = x[i + k] * pre_gain;
+
+            if ((i + BLOCK) % FFT_SIZE == 0) {
+                spectrum_bands(&x[i + BLOCK - FFT_SIZE], fs, bands);
+                vad_update_spectrum(&vad, bands);
+            }
+
+            int got = vad_process_block(&vad, blk, BLOCK);
+            int ref = is_speech(regions, n_reg, (i + BLOCK / 2) / (double)fs);
+            if (got && ref) s.tp++;
+            else if (got)   s.fp++;
+            else if (ref)   s.fn++;
+            else            s.tn++;
+        }
+
+        print_score(argv[argi], &s);
+        total.tp += s.tp; total.fp += s.fp; total.tn += s.tn; total.fn += s.fn;
+        free(x);
+    }
+
+    print_score("TOTAL", &total);
+    return 0;
+}